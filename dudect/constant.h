@@ -16,7 +16,8 @@
     _(insert_head) \
     _(insert_tail) \
     _(remove_head) \
-    _(remove_tail)
+    _(remove_tail) \
+    _(delete_mid)
 
 #define DUT(x) DUT_##x
 
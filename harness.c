@@ -1,7 +1,10 @@
 /* Test support code */
 
+#include <pthread.h>
+#include <sched.h>
 #include <setjmp.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,34 +33,78 @@
 
 /* Data structures used by our code */
 
-/* Represent allocated blocks as doubly-linked list, with
- * next and prev pointers at beginning
- */
+/* Header placed in front of every allocated block */
 typedef struct __block_element {
-    struct __block_element *next, *prev;
+    struct __block_list *list;    /* List the block is recorded in */
+    struct __block_element *next; /* Next freed block in quarantine */
     size_t payload_size;
     size_t magic_header; /* Marker to see if block seems legitimate */
     unsigned char payload[0];
     /* Also place magic number at tail of every block */
 } block_element_t;
 
-static block_element_t *allocated = NULL;
-static size_t allocated_count = 0;
+/* Every thread records the blocks it allocates in a list of its own, so that
+ * threads allocating and freeing their own blocks never contend. The lock of
+ * a list is only ever fought over when a thread frees a block allocated by
+ * another one. Lists outlive their threads: the blocks left on them still
+ * count, and the list is handed to the next thread that starts allocating.
+ * Lists are only ever pushed in front of @lists, so walking them from a
+ * snapshot of @lists needs no lock.
+ *
+ * A list is an open-addressing hash set of block addresses with linear
+ * probing, so that cautious mode finds out whether a block is allocated in
+ * constant time however many blocks are live. @allocated has @mask + 1
+ * slots, a power of two, and is kept at most half full.
+ *
+ * Poisoned blocks freed by the owner of a list are not handed back to malloc
+ * at once, but wait in a FIFO quarantine from @quarantine to
+ * @quarantine_tail, holding @quarantined bytes. A block leaving quarantine
+ * must still be poisoned, which catches writes to it after it was freed.
+ */
+typedef struct __block_list {
+    block_element_t **allocated;
+    size_t mask;
+    size_t allocated_count;
+    block_element_t *quarantine, *quarantine_tail;
+    size_t quarantined;
+    atomic_flag lock;
+    bool in_use;               /* Owned by a running thread */
+    struct __block_list *next; /* Next of all the lists ever created */
+} block_list_t;
+
+static _Atomic(block_list_t *) lists = NULL;
+static pthread_mutex_t lists_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t list_key;
+static pthread_once_t list_key_once = PTHREAD_ONCE_INIT;
+
+/* List of the calling thread, and the list lock it holds if any */
+static __thread block_list_t *thread_list = NULL;
+static __thread block_list_t *held_list = NULL;
 
 /* Percent probability of malloc failure */
 int fail_probability = 0;
 
+/* Fill the payload of every Nth block with FILLCHAR when it is allocated and
+ * freed: 1 for every block, 0 for none, leaving only the header and footer
+ * canaries.
+ */
+int poison_interval = 1;
+
+/* Bytes of poisoned blocks each thread keeps back from malloc once freed */
+int quarantine_size = 1 << 20;
+
 static bool cautious_mode = true;
 static bool noallocate_mode = false;
-static bool error_occurred = false;
-static char *error_message = "";
+static __thread bool error_occurred = false;
+static __thread char *error_message = "";
 
-static int time_limit = 1;
+/* Seconds allowed for an operation guarded by exception_setup(true) */
+int time_limit = 1;
 
-/* Data for managing exceptions */
-static jmp_buf env;
-static volatile sig_atomic_t jmp_ready = false;
-static bool time_limited = false;
+/* Data for managing exceptions, private to each thread */
+static __thread jmp_buf env;
+static __thread volatile sig_atomic_t jmp_ready = false;
+static __thread bool time_limited = false;
 
 /* For test_malloc and test_calloc */
 typedef enum {
@@ -67,6 +114,133 @@ typedef enum {
 
 /* Internal functions */
 
+static void lock_list(block_list_t *l)
+{
+    while (atomic_flag_test_and_set_explicit(&l->lock, memory_order_acquire))
+        sched_yield();
+    held_list = l;
+}
+
+static void unlock_list(block_list_t *l)
+{
+    held_list = NULL;
+    atomic_flag_clear_explicit(&l->lock, memory_order_release);
+}
+
+/* Hand the list of an exiting thread over to the next new thread */
+static void release_list(void *l)
+{
+    pthread_mutex_lock(&lists_lock);
+    ((block_list_t *) l)->in_use = false;
+    pthread_mutex_unlock(&lists_lock);
+}
+
+static void make_list_key()
+{
+    pthread_key_create(&list_key, release_list);
+}
+
+/* Get the block list of the calling thread, adopting a list left by an exited
+ * thread or creating one on its first allocation
+ */
+static block_list_t *get_thread_list()
+{
+    if (thread_list)
+        return thread_list;
+
+    pthread_once(&list_key_once, make_list_key);
+    pthread_mutex_lock(&lists_lock);
+    block_list_t *l = atomic_load(&lists);
+    while (l && l->in_use)
+        l = l->next;
+    if (!l) {
+        l = calloc(1, sizeof(block_list_t));
+        if (!l) {
+            pthread_mutex_unlock(&lists_lock);
+            report_event(MSG_FATAL, "Couldn't allocate any more memory");
+            return NULL;
+        }
+        atomic_flag_clear(&l->lock);
+        l->next = atomic_load(&lists);
+        atomic_store(&lists, l);
+    }
+    l->in_use = true;
+    pthread_mutex_unlock(&lists_lock);
+
+    pthread_setspecific(list_key, l);
+    thread_list = l;
+    return l;
+}
+
+/* Home slot of block @b in a set of @mask + 1 slots */
+static size_t block_slot(const block_element_t *b, size_t mask)
+{
+    /* Fibonacci hashing, the low bits of addresses are mostly alignment */
+    uint64_t h = (uint64_t) (uintptr_t) b * 0x9E3779B97F4A7C15ULL;
+    return (size_t) (h >> 32) & mask;
+}
+
+/* Slot holding block @b in list @l, or the empty slot where it would go */
+static size_t block_probe(const block_list_t *l, const block_element_t *b)
+{
+    size_t i = block_slot(b, l->mask);
+    while (l->allocated[i] && l->allocated[i] != b)
+        i = (i + 1) & l->mask;
+    return i;
+}
+
+/* Double the slots of list @l, once it would get more than half full */
+static bool block_grow(block_list_t *l)
+{
+    size_t cap = l->allocated ? 2 * (l->mask + 1) : 64;
+    block_element_t **slot = calloc(cap, sizeof(block_element_t *));
+    if (!slot)
+        return false;
+
+    block_element_t **old = l->allocated;
+    size_t old_cap = old ? l->mask + 1 : 0;
+    l->allocated = slot;
+    l->mask = cap - 1;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i])
+            l->allocated[block_probe(l, old[i])] = old[i];
+    }
+    free(old);
+    return true;
+}
+
+/* Remove block @b from list @l, shifting back the blocks probed past it */
+static void block_unlink(block_list_t *l, block_element_t *b)
+{
+    size_t i = block_probe(l, b);
+    size_t j = i;
+
+    l->allocated[i] = NULL;
+    for (;;) {
+        j = (j + 1) & l->mask;
+        if (!l->allocated[j])
+            break;
+        /* Move the block back if its home slot is not in (i, j] */
+        size_t k = block_slot(l->allocated[j], l->mask);
+        if (((j - k) & l->mask) >= ((j - i) & l->mask)) {
+            l->allocated[i] = l->allocated[j];
+            l->allocated[j] = NULL;
+            i = j;
+        }
+    }
+    l->allocated_count--;
+}
+
+/* Should the payload of the block being allocated or freed be poisoned? */
+static bool poison_block()
+{
+    static __thread unsigned int count = 0;
+
+    if (poison_interval <= 1)
+        return poison_interval == 1;
+    return !(++count % poison_interval);
+}
+
 /* Should this allocation fail? */
 static bool fail_allocation()
 {
@@ -74,8 +248,55 @@ static bool fail_allocation()
     return (weight < 0.01 * fail_probability);
 }
 
-/* Find header of block, given its payload.
- * Signal error if doesn't seem like legitimate block
+/* Is @b recorded as allocated in list @l? */
+/* Remove @b from list @l if it is recorded there, under a single lock so
+ * that two threads freeing the same block cannot both remove it
+ */
+static bool take_from_list(block_list_t *l, block_element_t *b)
+{
+    lock_list(l);
+    bool found = l->allocated && l->allocated[block_probe(l, b)] == b;
+    if (found)
+        block_unlink(l, b);
+    unlock_list(l);
+    return found;
+}
+
+/* Remove @b from the list of the thread that allocated it.
+ * In cautious mode, the list named by its header is searched first, so that
+ * freeing a block only locks the list of the thread that allocated it, and
+ * the others are only searched when the header does not lead to the block.
+ * Return the list @b was removed from, or NULL if it is not allocated.
+ */
+static block_list_t *take_block(block_element_t *b)
+{
+    if (!cautious_mode) {
+        block_list_t *l = b->list;
+        lock_list(l);
+        block_unlink(l, b);
+        unlock_list(l);
+        return l;
+    }
+
+    block_list_t *owner = NULL;
+    if (b->magic_header == MAGICHEADER) {
+        /* Make sure the header names one of the lists before locking it */
+        for (block_list_t *l = atomic_load(&lists); l && !owner; l = l->next)
+            owner = l == b->list ? l : NULL;
+        if (owner && take_from_list(owner, b))
+            return owner;
+    }
+
+    for (block_list_t *l = atomic_load(&lists); l; l = l->next) {
+        if (l != owner && take_from_list(l, b))
+            return l;
+    }
+    return NULL;
+}
+
+/* Find header of block, given its payload, and remove it from its list.
+ * Signal error if doesn't seem like legitimate block, and return NULL if
+ * cautious mode finds it is not allocated
  */
 static block_element_t *find_header(void *p)
 {
@@ -86,20 +307,11 @@ static block_element_t *find_header(void *p)
 
     block_element_t *b =
         (block_element_t *) ((size_t) p - sizeof(block_element_t));
-    if (cautious_mode) {
-        /* Make sure this is really an allocated block */
-        block_element_t *ab = allocated;
-        bool found = false;
-        while (ab && !found) {
-            found = ab == b;
-            ab = ab->next;
-        }
-        if (!found) {
-            report_event(MSG_ERROR,
-                         "Attempted to free unallocated block.  Address = %p",
-                         p);
-            error_occurred = true;
-        }
+    if (!take_block(b)) {
+        report_event(MSG_ERROR,
+                     "Attempted to free unallocated block.  Address = %p", p);
+        error_occurred = true;
+        return NULL;
     }
 
     if (b->magic_header != MAGICHEADER) {
@@ -122,6 +334,63 @@ static size_t *find_footer(block_element_t *b)
     return p;
 }
 
+/* Bytes taken from malloc for block @b */
+static size_t block_size(const block_element_t *b)
+{
+    return b->payload_size + sizeof(block_element_t) + sizeof(size_t);
+}
+
+/* Check that freed block @b has not been written since, then free it */
+static void release_block(block_element_t *b)
+{
+    bool poisoned =
+        b->magic_header == MAGICFREE && *find_footer(b) == MAGICFREE;
+    for (size_t i = 0; poisoned && i < b->payload_size; i++)
+        poisoned = b->payload[i] == FILLCHAR;
+
+    if (!poisoned) {
+        report_event(MSG_ERROR,
+                     "Block with address %p was written after being freed",
+                     (void *) &b->payload);
+        error_occurred = true;
+    }
+    free(b);
+}
+
+/* Release the oldest blocks in quarantine of locked list @l until it holds
+ * no more than @limit bytes
+ */
+static void evict_blocks(block_list_t *l, size_t limit)
+{
+    while (l->quarantined > limit) {
+        block_element_t *old = l->quarantine;
+        l->quarantine = old->next;
+        if (!l->quarantine)
+            l->quarantine_tail = NULL;
+        l->quarantined -= block_size(old);
+        release_block(old);
+    }
+}
+
+/* Put freed and poisoned block @b in quarantine, evicting the oldest blocks
+ * beyond quarantine_size bytes
+ */
+static void quarantine_block(block_element_t *b)
+{
+    block_list_t *l = get_thread_list();
+
+    lock_list(l);
+    b->next = NULL;
+    if (l->quarantine_tail)
+        l->quarantine_tail->next = b;
+    else
+        l->quarantine = b;
+    l->quarantine_tail = b;
+    l->quarantined += block_size(b);
+    evict_blocks(l, quarantine_size);
+    unlock_list(l);
+}
+
 static void *alloc(alloc_t alloc_type, size_t size)
 {
     if (noallocate_mode) {
@@ -142,6 +411,7 @@ static void *alloc(alloc_t alloc_type, size_t size)
         return NULL;
     }
 
+    block_list_t *l = get_thread_list();
     block_element_t *new_block =
         malloc(size + sizeof(block_element_t) + sizeof(size_t));
     if (!new_block) {
@@ -155,16 +425,25 @@ static void *alloc(alloc_t alloc_type, size_t size)
     new_block->payload_size = size;
     *find_footer(new_block) = MAGICFOOTER;
     void *p = (void *) &new_block->payload;
-    memset(p, !alloc_type * FILLCHAR, size);
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->next = allocated;
+    if (alloc_type == TEST_CALLOC)
+        memset(p, 0, size);
+    else if (poison_block())
+        memset(p, FILLCHAR, size);
     // cppcheck-suppress nullPointerRedundantCheck
-    new_block->prev = NULL;
+    new_block->list = l;
 
-    if (allocated)
-        allocated->prev = new_block;
-    allocated = new_block;
-    allocated_count++;
+    lock_list(l);
+    if (2 * (l->allocated_count + 1) > (l->allocated ? l->mask + 1 : 0) &&
+        !block_grow(l)) {
+        unlock_list(l);
+        free(new_block);
+        report_event(MSG_FATAL, "Couldn't allocate any more memory");
+        error_occurred = true;
+        return NULL;
+    }
+    l->allocated[block_probe(l, new_block)] = new_block;
+    l->allocated_count++;
+    unlock_list(l);
 
     return p;
 }
@@ -198,6 +477,9 @@ void test_free(void *p)
         return;
 
     block_element_t *b = find_header(p);
+    if (!b)
+        return;
+
     size_t footer = *find_footer(b);
     if (footer != MAGICFOOTER) {
         report_event(MSG_ERROR,
@@ -208,20 +490,14 @@ void test_free(void *p)
     }
     b->magic_header = MAGICFREE;
     *find_footer(b) = MAGICFREE;
-    memset(p, FILLCHAR, b->payload_size);
+    bool poisoned = poison_block();
+    if (poisoned)
+        memset(p, FILLCHAR, b->payload_size);
 
-    /* Unlink from list */
-    block_element_t *bn = b->next;
-    block_element_t *bp = b->prev;
-    if (bp)
-        bp->next = bn;
+    if (poisoned)
+        quarantine_block(b);
     else
-        allocated = bn;
-    if (bn)
-        bn->prev = bp;
-
-    free(b);
-    allocated_count--;
+        free(b);
 }
 
 // cppcheck-suppress unusedFunction
@@ -237,7 +513,16 @@ char *test_strdup(const char *s)
 
 size_t allocation_check()
 {
-    return allocated_count;
+    size_t count = 0;
+
+    for (block_list_t *l = atomic_load(&lists); l; l = l->next) {
+        lock_list(l);
+        /* Catch writes to the blocks still in quarantine as well */
+        evict_blocks(l, 0);
+        count += l->allocated_count;
+        unlock_list(l);
+    }
+    return count;
 }
 
 /* Implementation of functions for testing */
@@ -245,6 +530,7 @@ size_t allocation_check()
 /* Set/unset cautious mode.
  * In this mode, makes extra sure any block to be freed is currently allocated.
  */
+// cppcheck-suppress unusedFunction
 void set_cautious_mode(bool cautious)
 {
     cautious_mode = cautious;
@@ -272,7 +558,9 @@ bool error_check()
 bool exception_setup(bool limit_time)
 {
     if (sigsetjmp(env, 1)) {
-        /* Got here from longjmp */
+        /* Got here from longjmp, maybe right out of test_malloc/test_free */
+        if (held_list)
+            unlock_list(held_list);
         jmp_ready = false;
         if (time_limited) {
             alarm(0);
@@ -8,6 +8,9 @@
 /* This test harness enables us to do stringent testing of code.
  * It overloads the library versions of malloc and free with ones that
  * allow checking for common allocation errors.
+ *
+ * The allocation functions may be called from any number of threads, and a
+ * block may be freed by a thread other than the one that allocated it.
  */
 
 void *test_malloc(size_t size);
@@ -18,12 +21,25 @@ char *test_strdup(const char *s);
 
 #ifdef INTERNAL
 
-/* Report number of allocated blocks */
+/* Report number of allocated blocks, summed over all threads, after checking
+ * and freeing every block in quarantine
+ */
 size_t allocation_check();
 
 /* Probability of malloc failing, expressed as percent */
 extern int fail_probability;
 
+/* Poison the payload of every Nth block on malloc and free, 0 for none */
+extern int poison_interval;
+
+/* Bytes of poisoned blocks each thread holds back from reuse after they are
+ * freed, checked for late writes when they leave, 0 to free them at once
+ */
+extern int quarantine_size;
+
+/* Time limit in seconds for operations run under exception_setup(true) */
+extern int time_limit;
+
 /*
  * Set/unset cautious mode.
  * In this mode, makes extra sure any block to be freed is currently allocated.
@@ -36,11 +52,14 @@ void set_cautious_mode(bool cautious);
  */
 void set_noallocate_mode(bool noallocate);
 
-/* Return whether any errors have occurred since last time checked */
+/* Return whether any errors have occurred since last time checked, in the
+ * calling thread
+ */
 bool error_check();
 
 /* Prepare for a risky operation using setjmp.
- * Function returns true for initial return, false for error return
+ * Function returns true for initial return, false for error return.
+ * Each thread has exception context of its own.
  */
 bool exception_setup(bool limit_time);
 
@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpmc.h"
+
+/* Create an empty MPMC queue */
+mpmc_t *mpmc_new(size_t capacity)
+{
+    size_t cap = 2;
+    while (cap < capacity)
+        cap <<= 1;
+
+    mpmc_t *q = malloc(sizeof(mpmc_t));
+    if (!q)
+        return NULL;
+
+    q->cell = malloc(cap * sizeof(mpmc_cell_t));
+    if (!q->cell) {
+        free(q);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < cap; i++) {
+        atomic_init(&q->cell[i].seq, i);
+        q->cell[i].value = NULL;
+    }
+    q->mask = cap - 1;
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->head, 0);
+    return q;
+}
+
+/* Free all storage used by queue */
+void mpmc_free(mpmc_t *q)
+{
+    if (!q)
+        return;
+
+    while (mpmc_remove_head(q, NULL, 0))
+        ;
+    free(q->cell);
+    free(q);
+}
+
+/* Insert a copy of @s at tail of queue */
+bool mpmc_insert_tail(mpmc_t *q, const char *s)
+{
+    char *value = strdup(s);
+    if (!value)
+        return false;
+
+    size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    mpmc_cell_t *cell;
+    for (;;) {
+        cell = &q->cell[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t) seq - (intptr_t) pos;
+
+        if (!dif) {
+            /* The cell is free for this lap, claim the position */
+            if (atomic_compare_exchange_weak_explicit(
+                    &q->tail, &pos, pos + 1, memory_order_relaxed,
+                    memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            /* The consumers have not emptied the cell of the last lap */
+            free(value);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+
+    cell->value = value;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+/* Remove the string from head of queue */
+bool mpmc_remove_head(mpmc_t *q, char *sp, size_t bufsize)
+{
+    size_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    mpmc_cell_t *cell;
+    for (;;) {
+        cell = &q->cell[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t) seq - (intptr_t) (pos + 1);
+
+        if (!dif) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &q->head, &pos, pos + 1, memory_order_relaxed,
+                    memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            /* No producer has filled the cell yet */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+
+    char *value = cell->value;
+    /* Hand the cell over to the producers of the next lap */
+    atomic_store_explicit(&cell->seq, pos + q->mask + 1, memory_order_release);
+
+    if (sp && bufsize) {
+        strncpy(sp, value, bufsize - 1);
+        sp[bufsize - 1] = '\0';
+    }
+    free(value);
+    return true;
+}
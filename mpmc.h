@@ -0,0 +1,97 @@
+#ifndef LAB0_MPMC_H
+#define LAB0_MPMC_H
+
+/* This program implements a bounded lock-free queue of strings, which any
+ * number of threads may insert into and remove from at the same time.
+ *
+ * It is Dmitry Vyukov's MPMC ring: every cell carries a sequence number that
+ * tells producers and consumers whether it is free or holds a string for the
+ * current lap, so both ends only need one compare-and-swap on their own
+ * position. Cells are allocated once with the ring and never freed while it
+ * is in use, and each string belongs to exactly one thread at a time, from
+ * the producer that copied it to the consumer that removes it. No node is
+ * ever unlinked under a concurrent reader, so unlike a linked lock-free queue
+ * it needs no hazard pointers or epochs to reclaim memory.
+ *
+ * The strings are allocated with the plain C library allocator, so the queue
+ * does not depend on the test harness.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Size of a cache line, the distance kept between the two positions */
+#define MPMC_CACHE_LINE 64
+
+/**
+ * mpmc_cell_t - Cell of an MPMC ring
+ * @seq: position the cell is ready for: equal to it when free for an
+ *       insertion, one past it when holding a string to remove
+ * @value: string held by the cell
+ */
+typedef struct {
+    _Atomic size_t seq;
+    char *value;
+} mpmc_cell_t;
+
+/**
+ * mpmc_t - Bounded multi-producer multi-consumer queue of strings
+ * @cell: array of @mask + 1 cells, a power of two
+ * @mask: capacity minus one, maps positions to cells
+ * @tail: position of the next insertion
+ * @head: position of the next removal
+ *
+ * Positions only ever grow, @tail and @head sit on cache lines of their own
+ * so that producers and consumers do not contend on the same line.
+ */
+typedef struct {
+    mpmc_cell_t *cell;
+    size_t mask;
+    char pad0[MPMC_CACHE_LINE];
+    _Atomic size_t tail;
+    char pad1[MPMC_CACHE_LINE - sizeof(size_t)];
+    _Atomic size_t head;
+    char pad2[MPMC_CACHE_LINE - sizeof(size_t)];
+} mpmc_t;
+
+/**
+ * mpmc_new() - Create an empty MPMC queue
+ * @capacity: number of strings it can hold, rounded up to a power of two
+ *
+ * Return: NULL for allocation failed
+ */
+mpmc_t *mpmc_new(size_t capacity);
+
+/**
+ * mpmc_free() - Free all storage used by queue, no effect if it is NULL
+ * @q: MPMC queue, no longer used by any other thread
+ */
+void mpmc_free(mpmc_t *q);
+
+/**
+ * mpmc_insert_tail() - Insert a copy of a string at the tail
+ * @q: MPMC queue
+ * @s: string would be inserted
+ *
+ * Never blocks: a full queue makes the call fail, and the caller decides
+ * whether to retry.
+ *
+ * Return: true for success, false if queue is full or allocation failed
+ */
+bool mpmc_insert_tail(mpmc_t *q, const char *s);
+
+/**
+ * mpmc_remove_head() - Remove the string from the head
+ * @q: MPMC queue
+ * @sp: buffer receiving the removed string, may be NULL
+ * @bufsize: size of @sp
+ *
+ * Copy up to @bufsize - 1 characters of the string to @sp, plus a null
+ * terminator, then free it. Never blocks.
+ *
+ * Return: true for success, false if queue is empty
+ */
+bool mpmc_remove_head(mpmc_t *q, char *sp, size_t bufsize);
+
+#endif /* LAB0_MPMC_H */
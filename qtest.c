@@ -3,8 +3,12 @@
 #include <assert.h>
 #include <errno.h>
 #include <getopt.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <spawn.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,6 +23,7 @@
 #include <time.h>
 #endif
 
+#include "dudect/cpucycles.h"
 #include "dudect/fixture.h"
 #include "list.h"
 #include "random.h"
@@ -45,7 +50,10 @@ extern int show_entropy;
 #include "queue.h"
 
 #include "console.h"
+#include "mpmc.h"
 #include "report.h"
+#include "ring.h"
+#include "spsc.h"
 
 /* Settable parameters */
 
@@ -53,7 +61,6 @@ extern int show_entropy;
 
 /* How large is a queue before it's considered big.
  * This affects how it gets printed
- * and whether cautious mode is used when freeing the queue
  */
 #define BIG_LIST_SIZE 30
 
@@ -75,6 +82,15 @@ static int string_length = MAXSTRING;
 
 static int descend = 0;
 
+/* Whether new queues allocate their elements from a node pool */
+static int use_pool = 0;
+
+/* Whether new queues share the strings of equal elements */
+static int use_intern = 0;
+
+static int sort_algo = Q_SORT_MERGE;
+static int sort_threads = 1;
+
 #define MIN_RANDSTR_LEN 5
 #define MAX_RANDSTR_LEN 10
 static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
@@ -101,9 +117,6 @@ static bool do_free(int argc, char *argv[])
     }
     error_check();
 
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
-
     struct list_head *qnext = NULL;
     if (chain.size > 1) {
         qnext = (current->chain.next == &chain.head) ? chain.head.next
@@ -116,7 +129,6 @@ static bool do_free(int argc, char *argv[])
         if (exception_setup(true))
             q_free(current->q);
         exception_cancel();
-        set_cautious_mode(true);
     }
 
     if (current) {
@@ -154,6 +166,10 @@ static bool do_new(int argc, char *argv[])
         qctx->size = 0;
         qctx->q = q_new();
         qctx->id = chain.size++;
+        if (use_pool && qctx->q && !q_pool_enable(qctx->q))
+            report(2, "Allocating node pool failed, using plain allocation");
+        if (use_intern && qctx->q)
+            q_intern_enable(qctx->q);
 
         current = qctx;
     }
@@ -180,6 +196,74 @@ static void fill_rand_string(char *buf, size_t buf_size)
     buf[len] = '\0';
 }
 
+/* Insert @reps copies of @inserts, or @reps random strings if @need_rand, with
+ * a single call to the bulk insertion API. Return false if nothing could be
+ * inserted that way.
+ */
+static bool queue_insert_bulk(position_t pos,
+                              char *inserts,
+                              bool need_rand,
+                              int reps,
+                              bool *ok)
+{
+    char *buf = NULL;
+    size_t stride = 0;
+
+    if (need_rand) {
+        stride = MAX_RANDSTR_LEN;
+        buf = malloc(reps * stride);
+        if (!buf)
+            return false;
+        for (int r = 0; r < reps; r++)
+            fill_rand_string(buf + r * stride, stride);
+        inserts = buf;
+    }
+
+    bool rval = pos == POS_TAIL
+                    ? q_insert_tail_bulk(current->q, inserts, stride, reps)
+                    : q_insert_head_bulk(current->q, inserts, stride, reps);
+    if (rval) {
+        current->size += reps;
+
+        /* Going away from the insertion point, the new elements hold the
+         * strings in reverse order for both ends of the queue.
+         */
+        struct list_head *node = current->q;
+        char *lasts = NULL;
+        bool interns = q_interns(current->q);
+        for (int r = reps - 1; r >= 0; r--) {
+            node = pos == POS_TAIL ? node->prev : node->next;
+            char *cur_inserts = list_entry(node, element_t, list)->value;
+            if (!cur_inserts) {
+                report(1, "ERROR: Failed to save copy of string in queue");
+                *ok = false;
+                break;
+            } else if (cur_inserts == inserts + r * stride) {
+                report(1,
+                       "ERROR: Need to allocate and copy string for new "
+                       "queue element");
+                *ok = false;
+                break;
+            } else if (lasts && (cur_inserts == lasts) !=
+                                    (interns && !strcmp(cur_inserts, lasts))) {
+                /* Equal random strings are shared too when interning */
+                report(1, cur_inserts != lasts
+                              ? "ERROR: Need to share interned string "
+                                "between equal queue elements"
+                              : "ERROR: Need to allocate separate string "
+                                "for each queue element");
+                *ok = false;
+                break;
+            }
+            lasts = cur_inserts;
+        }
+        *ok = *ok && !error_check();
+    }
+
+    free(buf);
+    return rval;
+}
+
 /* insertion */
 static bool queue_insert(position_t pos, int argc, char *argv[])
 {
@@ -226,7 +310,12 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
                pos == POS_TAIL ? "tail" : "head");
     error_check();
 
+    bool interns = current && q_interns(current->q);
     if (current && exception_setup(true)) {
+        /* One element at a time only if the bulk insertion failed */
+        if (reps > 1 && queue_insert_bulk(pos, inserts, need_rand, reps, &ok))
+            reps = 0;
+
         for (int r = 0; ok && r < reps; r++) {
             if (need_rand)
                 fill_rand_string(randstr_buf, sizeof(randstr_buf));
@@ -248,10 +337,14 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
                            "queue element");
                     ok = false;
                     break;
-                } else if (r == 1 && lasts == cur_inserts) {
-                    report(1,
-                           "ERROR: Need to allocate separate string for each "
-                           "queue element");
+                } else if (r == 1 && lasts &&
+                           (lasts == cur_inserts) !=
+                               (interns && !strcmp(lasts, cur_inserts))) {
+                    report(1, lasts != cur_inserts
+                                  ? "ERROR: Need to share interned string "
+                                    "between equal queue elements"
+                                  : "ERROR: Need to allocate separate "
+                                    "string for each queue element");
                     ok = false;
                     break;
                 }
@@ -288,6 +381,104 @@ static bool do_it(int argc, char *argv[])
     return queue_insert(POS_TAIL, argc, argv);
 }
 
+/* Remove @n elements from head of queue with a single q_remove_head_n() */
+static bool queue_remove_n(int n)
+{
+    if (n <= 0) {
+        report(1, "Invalid number of removals '%d'", n);
+        return false;
+    }
+
+    if (!current || !current->size)
+        report(3, "Warning: Calling remove head on empty queue");
+    error_check();
+
+    /* Size the arena for the strings about to be removed, followed by
+     * padding that must stay untouched.
+     */
+    size_t len = 0;
+    int expected = 0;
+    element_t *item, *tmp;
+    if (current) {
+        list_for_each_entry (item, current->q, list) {
+            if (expected == n)
+                break;
+            len += strlen(item->value) + 1;
+            expected++;
+        }
+    }
+
+    char *removes = malloc(len + STRINGPAD);
+    if (!removes) {
+        report(1,
+               "INTERNAL ERROR.  Could not allocate space for removed strings");
+        return false;
+    }
+    memset(removes, 'X', len + STRINGPAD);
+
+    struct list_head removed;
+    INIT_LIST_HEAD(&removed);
+    int cnt = 0;
+    if (current && exception_setup(true))
+        cnt = q_remove_head_n(current->q, &removed, n, removes, len);
+    exception_cancel();
+
+    bool ok = true;
+    if (cnt != expected) {
+        report(1, "ERROR: Removed %d elements, expected %d", cnt, expected);
+        ok = false;
+    }
+
+    /* Walk the detached elements alongside the packed strings */
+    char *packed = removes;
+    int i = 0;
+    list_for_each_entry (item, &removed, list) {
+        if (ok && strcmp(packed, item->value)) {
+            report(1, "ERROR: Removed value %s != packed value %s",
+                   item->value, packed);
+            ok = false;
+        }
+        packed += strlen(packed) + 1;
+        i++;
+    }
+    if (ok && i != cnt) {
+        report(1, "ERROR: %d elements were detached, but %d reported", i, cnt);
+        ok = false;
+    }
+
+    size_t j = len;
+    while (j < len + STRINGPAD && removes[j] == 'X')
+        j++;
+    if (j != len + STRINGPAD) {
+        report(1,
+               "ERROR: copying of strings in remove_head_n overflowed "
+               "destination buffer.");
+        ok = false;
+    }
+
+    list_for_each_entry_safe (item, tmp, &removed, list)
+        q_release_element(item);
+
+    if (cnt) {
+        current->size -= cnt;
+        report(2, "Removed %d elements from queue", cnt);
+    } else {
+        fail_count++;
+        if (fail_count < fail_limit) {
+            report(2, "Removal from queue failed");
+        } else {
+            report(1, "ERROR: Removal from queue failed (%d failures total)",
+                   fail_count);
+            ok = false;
+        }
+    }
+
+    q_show(3);
+
+    free(removes);
+    return ok && !error_check();
+}
+
 static bool queue_remove(position_t pos, int argc, char *argv[])
 {
     /* FIXME: It is known that both functions is_remove_tail_const() and
@@ -417,10 +608,60 @@ static inline bool do_rt(int argc, char *argv[])
     return queue_remove(POS_TAIL, argc, argv);
 }
 
+static bool do_rhn(int argc, char *argv[])
+{
+    int n;
+    if (argc != 2 || !get_int(argv[1], &n)) {
+        report(1, "%s needs a number of elements to remove", argv[0]);
+        return false;
+    }
+    return queue_remove_n(n);
+}
+
+static int cmp_value(const void *a, const void *b)
+{
+    return strcmp((*(element_t *const *) a)->value,
+                  (*(element_t *const *) b)->value);
+}
+
+/* Remove every string occurring more than once from the @n elements of @l,
+ * keeping the order of the others. Return false if allocation failed.
+ */
+static bool drop_all_dups(struct list_head *l, size_t n)
+{
+    element_t **v = malloc(n * sizeof(*v));
+    if (!v)
+        return false;
+
+    size_t i = 0;
+    element_t *item;
+    list_for_each_entry (item, l, list)
+        v[i++] = item;
+    qsort(v, n, sizeof(*v), cmp_value);
+
+    for (i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && strcmp(v[i]->value, v[j]->value) == 0)
+            j++;
+        if (j - i > 1) {
+            for (; i < j; i++) {
+                list_del(&v[i]->list);
+                free(v[i]->value);
+                free(v[i]);
+            }
+        }
+        i = j;
+    }
+
+    free(v);
+    return true;
+}
+
 static bool do_dedup(int argc, char *argv[])
 {
-    if (argc != 1) {
-        report(1, "%s takes no arguments", argv[0]);
+    bool all = argc == 2 && strcmp(argv[1], "all") == 0;
+    if (argc != 1 && !all) {
+        report(1, "%s takes no arguments other than 'all'", argv[0]);
         return false;
     }
 
@@ -431,6 +672,7 @@ static bool do_dedup(int argc, char *argv[])
 
     LIST_HEAD(l_copy);
     element_t *item = NULL, *tmp = NULL;
+    size_t n = 0;
 
     // Copy current->q to l_copy
     if (current->q && !list_empty(current->q)) {
@@ -448,6 +690,7 @@ static bool do_dedup(int argc, char *argv[])
             }
             memcpy(tmp->value, item->value, slen);
             list_add_tail(&tmp->list, &l_copy);
+            n++;
         }
         // Return false if the loop does not leave properly
         if (&item->list != current->q) {
@@ -464,7 +707,7 @@ static bool do_dedup(int argc, char *argv[])
 
     bool ok = true;
     if (exception_setup(true))
-        ok = q_delete_dup(current->q);
+        ok = all ? q_delete_dup_all(current->q) : q_delete_dup(current->q);
     exception_cancel();
 
     if (!ok) {
@@ -472,29 +715,59 @@ static bool do_dedup(int argc, char *argv[])
             free(item->value);
             free(item);
         }
-        report(1, "ERROR: Calling delete duplicate on null queue");
+        if (all && n)
+            report(1, "ERROR: Could not allocate space to delete duplicates");
+        else
+            report(1, "ERROR: Calling delete duplicate on null queue");
         return false;
     }
 
     struct list_head *l_tmp = current->q->next;
-    bool is_this_dup = false;
-    // Compare between new list and old one
-    list_for_each_entry (item, &l_copy, list) {
-        // Skip comparison with new list if the string is duplicate
-        bool is_next_dup =
-            item->list.next != &l_copy &&
-            strcmp(list_entry(item->list.next, element_t, list)->value,
-                   item->value) == 0;
-        if (is_this_dup || is_next_dup) {
-            // Update list size
-            current->size--;
-        } else if (l_tmp != current->q &&
-                   strcmp(list_entry(l_tmp, element_t, list)->value,
-                          item->value) == 0)
+
+    if (all) {
+        // Strings may be duplicated anywhere, compute the expected list
+        if (!drop_all_dups(&l_copy, n)) {
+            list_for_each_entry_safe (item, tmp, &l_copy, list) {
+                free(item->value);
+                free(item);
+            }
+            report(1,
+                   "INTERNAL ERROR.  Could not allocate space for "
+                   "duplicate checking");
+            return false;
+        }
+
+        current->size = 0;
+        list_for_each_entry (item, &l_copy, list) {
+            if (l_tmp == current->q ||
+                strcmp(list_entry(l_tmp, element_t, list)->value,
+                       item->value) != 0) {
+                ok = false;
+                break;
+            }
             l_tmp = l_tmp->next;
-        else
-            ok = false;
-        is_this_dup = is_next_dup;
+            current->size++;
+        }
+    } else {
+        bool is_this_dup = false;
+        // Compare between new list and old one
+        list_for_each_entry (item, &l_copy, list) {
+            // Skip comparison with new list if the string is duplicate
+            bool is_next_dup =
+                item->list.next != &l_copy &&
+                strcmp(list_entry(item->list.next, element_t, list)->value,
+                       item->value) == 0;
+            if (is_this_dup || is_next_dup) {
+                // Update list size
+                current->size--;
+            } else if (l_tmp != current->q &&
+                       strcmp(list_entry(l_tmp, element_t, list)->value,
+                              item->value) == 0)
+                l_tmp = l_tmp->next;
+            else
+                ok = false;
+            is_this_dup = is_next_dup;
+        }
     }
     // All elements in new list should be traversed
     ok = ok && l_tmp == current->q;
@@ -576,6 +849,58 @@ static bool do_size(int argc, char *argv[])
     return ok && !error_check();
 }
 
+static bool do_find(int argc, char *argv[])
+{
+    if (argc != 2 && argc != 3) {
+        report(1, "%s takes 1-2 arguments", argv[0]);
+        return false;
+    }
+
+    int reps = 1;
+    if (argc == 3 && !get_int(argv[2], &reps)) {
+        report(1, "Invalid number of calls to find '%s'", argv[2]);
+        return false;
+    }
+
+    if (!current || !current->q) {
+        report(3, "Warning: Calling find on null queue");
+        return false;
+    }
+    error_check();
+
+    /* The first lookup builds the index, later ones only maintain it */
+    int cnt = 0;
+    bool ok = true;
+    if (exception_setup(true)) {
+        ok = q_index_enable(current->q);
+        for (int r = 0; ok && r < reps; r++) {
+            cnt = q_find(current->q, argv[1]);
+            ok = !error_check();
+        }
+    }
+    exception_cancel();
+
+    if (!ok)
+        return false;
+
+    int expect = 0;
+    element_t *item;
+    list_for_each_entry (item, current->q, list)
+        expect += !strcmp(item->value, argv[1]);
+
+    if (cnt != expect) {
+        report(1, "ERROR: Found %s %d times, but it occurs %d times", argv[1],
+               cnt, expect);
+        ok = false;
+    } else if (cnt) {
+        report(2, "Found %s %d time%s", argv[1], cnt, cnt == 1 ? "" : "s");
+    } else {
+        report(2, "%s not found", argv[1]);
+    }
+
+    return ok && !error_check();
+}
+
 bool do_sort(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -669,6 +994,21 @@ bool do_sort(int argc, char *argv[])
 
 static bool do_dm(int argc, char *argv[])
 {
+    if (simulation) {
+        if (argc != 1) {
+            report(1, "%s does not need arguments in simulation mode", argv[0]);
+            return false;
+        }
+        bool ok = is_delete_mid_const();
+        if (!ok) {
+            report(1,
+                   "ERROR: Probably not constant time or wrong implementation");
+            return false;
+        }
+        report(1, "Probably constant time");
+        return ok;
+    }
+
     if (argc != 1) {
         report(1, "%s takes no arguments", argv[0]);
         return false;
@@ -741,7 +1081,7 @@ static bool do_ascend(int argc, char *argv[])
 
     if (exception_setup(true))
         current->size = q_ascend(current->q);
-    set_noallocate_mode(false);
+    exception_cancel();
 
     bool ok = true;
 
@@ -788,7 +1128,7 @@ static bool do_descend(int argc, char *argv[])
 
     if (exception_setup(true))
         current->size = q_descend(current->q);
-    set_noallocate_mode(false);
+    exception_cancel();
 
     bool ok = true;
 
@@ -842,6 +1182,464 @@ static bool do_reverseK(int argc, char *argv[])
     return !error_check();
 }
 
+/* Check that ring @r holds the strings of queue @q in the same order */
+static bool ring_matches(struct list_head *q, const ring_t *r, const char *op)
+{
+    size_t i = 0;
+    element_t *item;
+    list_for_each_entry (item, q, list) {
+        const char *s = ring_get(r, i);
+        if (!s || strcmp(s, item->value)) {
+            report(1, "ERROR: Ring differs from queue at position %zu after %s",
+                   i, op);
+            return false;
+        }
+        i++;
+    }
+
+    if (i != ring_size(r)) {
+        report(1, "ERROR: Ring holds %zu strings, queue %zu after %s",
+               ring_size(r), i, op);
+        return false;
+    }
+    return true;
+}
+
+/* Insert the @n strings found MAX_RANDSTR_LEN bytes apart in @strs into the
+ * queue @q, or into the ring @r if @q is NULL, then remove them all from the
+ * head again. Tail insertions make this a FIFO workload, head insertions
+ * (@lifo) a LIFO one. Return the elapsed time in seconds.
+ */
+static double ring_workload(struct list_head *q,
+                            ring_t *r,
+                            char *strs,
+                            int n,
+                            bool lifo,
+                            bool *ok)
+{
+    char buf[MAX_RANDSTR_LEN];
+    double t = 0;
+
+    init_time(&t);
+    for (int i = 0; *ok && i < n; i++) {
+        char *s = strs + (size_t) i * MAX_RANDSTR_LEN;
+        bool rval = q ? (lifo ? q_insert_head(q, s) : q_insert_tail(q, s))
+                      : (lifo ? ring_insert_head(r, s)
+                              : ring_insert_tail(r, s));
+        if (!rval) {
+            report(1, "ERROR: Insertion of %s failed", s);
+            *ok = false;
+        }
+    }
+
+    for (int i = 0; *ok && i < n; i++) {
+        char *s = strs + (size_t) (lifo ? n - 1 - i : i) * MAX_RANDSTR_LEN;
+        if (q) {
+            element_t *e = q_remove_head(q, buf, sizeof(buf));
+            *ok = e;
+            if (e)
+                q_release_element(e);
+        } else {
+            *ok = ring_remove_head(r, buf, sizeof(buf));
+        }
+        if (!*ok || strcmp(buf, s)) {
+            report(1, "ERROR: Removed value %s != expected value %s",
+                   *ok ? buf : "NULL", s);
+            *ok = false;
+        }
+    }
+
+    return delta_time(&t);
+}
+
+static bool do_ring(int argc, char *argv[])
+{
+    int n = 1000000;
+    if (argc > 2 || (argc == 2 && (!get_int(argv[1], &n) || n < 1))) {
+        report(1, "%s takes an optional positive count", argv[0]);
+        return false;
+    }
+
+    char *strs = malloc((size_t) n * MAX_RANDSTR_LEN);
+    if (!strs) {
+        report(1, "INTERNAL ERROR.  Could not allocate space for strings");
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+        fill_rand_string(strs + (size_t) i * MAX_RANDSTR_LEN, MAX_RANDSTR_LEN);
+
+    struct list_head *q = q_new();
+    if (use_pool && q && !q_pool_enable(q))
+        report(2, "Allocating node pool failed, using plain allocation");
+    if (use_intern && q)
+        q_intern_enable(q);
+    ring_t *r = ring_new();
+    bool ok = q && r;
+    if (!ok)
+        report(1, "ERROR: Could not create the queue and the ring");
+
+    double fifo[2] = {0}, lifo[2] = {0};
+    if (ok && exception_setup(true)) {
+        /* The array versions of the reordering operations must agree with
+         * the list ones.
+         */
+        int m = n < 1000 ? n : 1000;
+        for (int i = 0; ok && i < m; i++) {
+            char *s = strs + (size_t) i * MAX_RANDSTR_LEN;
+            ok = q_insert_tail(q, s) && ring_insert_tail(r, s);
+            if (!ok)
+                report(1, "ERROR: Insertion of %s failed", s);
+        }
+        ok = ok && ring_matches(q, r, "insertion");
+        if (ok) {
+            q_reverse(q);
+            ring_reverse(r);
+            ok = ring_matches(q, r, "reverse");
+        }
+        if (ok) {
+            q_swap(q);
+            ring_swap(r);
+            ok = ring_matches(q, r, "swap");
+        }
+        if (ok) {
+            q_reverseK(q, 3);
+            ring_reverseK(r, 3);
+            ok = ring_matches(q, r, "reverseK");
+        }
+        while (ok && q_size(q)) {
+            ok = q_delete_mid(q) && ring_delete_mid(r) &&
+                 ring_matches(q, r, "delete mid");
+        }
+
+        for (int b = 0; ok && b < 2; b++) {
+            fifo[b] = ring_workload(b ? NULL : q, r, strs, n, false, &ok);
+            if (ok)
+                lifo[b] = ring_workload(b ? NULL : q, r, strs, n, true, &ok);
+        }
+    }
+    exception_cancel();
+
+    if (ok) {
+        report(1, "FIFO of %d strings: list %.3f s, ring %.3f s", n, fifo[0],
+               fifo[1]);
+        report(1, "LIFO of %d strings: list %.3f s, ring %.3f s", n, lifo[0],
+               lifo[1]);
+    }
+
+    q_free(q);
+    ring_free(r);
+    free(strs);
+    return ok && !error_check();
+}
+
+#define MAX_MPMC_THREADS 64
+
+/* Shared state of the threads of the mpmc command */
+struct mpmc_run {
+    mpmc_t *q;
+    char *strs;          /* strings to insert, MAX_RANDSTR_LEN bytes apart */
+    _Atomic int n;       /* number of strings the consumers wait for */
+    _Atomic int removed; /* strings removed so far by all consumers */
+};
+
+/* A producer or consumer thread with the latencies of its operations */
+struct mpmc_worker {
+    pthread_t thread;
+    struct mpmc_run *run;
+    int begin, end;     /* range of strings to insert, for a producer */
+    uint32_t *lat;      /* latency of each operation, in nanoseconds */
+    int ops;            /* number of operations done */
+    uint64_t checksum;  /* sum of the hashes of the strings removed */
+};
+
+static inline uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Hash of a string, summed over all strings to check that each of them was
+ * removed exactly once whatever the order
+ */
+static uint64_t mpmc_hash(const char *s)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s)
+        h = (h ^ (unsigned char) *s++) * 0x100000001b3ULL;
+    return h;
+}
+
+/* Insert strings @begin to @end, retrying while the queue is full. The
+ * latency of an insertion includes the time spent waiting for room. Waiting
+ * threads yield, so that the others can make progress on fewer cores.
+ */
+static void *mpmc_producer(void *arg)
+{
+    struct mpmc_worker *w = arg;
+    struct mpmc_run *run = w->run;
+
+    for (int i = w->begin; i < w->end; i++) {
+        const char *s = run->strs + (size_t) i * MAX_RANDSTR_LEN;
+        uint64_t t = now_ns();
+        while (!mpmc_insert_tail(run->q, s))
+            sched_yield();
+        w->lat[w->ops++] = now_ns() - t;
+    }
+    return NULL;
+}
+
+/* Remove strings until all of them have been removed by some consumer. The
+ * latency only counts the removals that succeeded.
+ */
+static void *mpmc_consumer(void *arg)
+{
+    struct mpmc_worker *w = arg;
+    struct mpmc_run *run = w->run;
+    char buf[MAX_RANDSTR_LEN];
+
+    while (atomic_load(&run->removed) < run->n) {
+        uint64_t t = now_ns();
+        if (!mpmc_remove_head(run->q, buf, sizeof(buf))) {
+            sched_yield();
+            continue;
+        }
+        w->lat[w->ops++] = now_ns() - t;
+        w->checksum += mpmc_hash(buf);
+        atomic_fetch_add(&run->removed, 1);
+    }
+    return NULL;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+/* Sort the @cnt latencies of @lat and report their percentiles */
+static void report_latency(const char *what,
+                           uint32_t *lat,
+                           size_t cnt,
+                           const char *unit)
+{
+    if (!cnt)
+        return;
+
+    qsort(lat, cnt, sizeof(uint32_t), cmp_u32);
+    report(1, "%s latency: p50 %u %s, p99 %u %s, p99.9 %u %s, max %u %s", what,
+           lat[cnt / 2], unit, lat[cnt * 99 / 100], unit,
+           lat[cnt * 999 / 1000], unit, lat[cnt - 1], unit);
+}
+
+/* Report the latency percentiles of the operations of @w[0..@k) */
+static void mpmc_report(const char *op, struct mpmc_worker *w, int k, int n)
+{
+    uint32_t *all = malloc((size_t) n * sizeof(uint32_t));
+    if (!all)
+        return;
+
+    size_t cnt = 0;
+    for (int i = 0; i < k; i++) {
+        memcpy(all + cnt, w[i].lat, w[i].ops * sizeof(uint32_t));
+        cnt += w[i].ops;
+    }
+    report_latency(op, all, cnt, "ns");
+    free(all);
+}
+
+static bool do_mpmc(int argc, char *argv[])
+{
+    int producers = 4, consumers = 4, n = 1000000;
+    if (argc > 4 || (argc > 1 && !get_int(argv[1], &producers)) ||
+        (argc > 2 && !get_int(argv[2], &consumers)) ||
+        (argc > 3 && !get_int(argv[3], &n)) || producers < 1 ||
+        consumers < 1 || producers + consumers > MAX_MPMC_THREADS || n < 1) {
+        report(1,
+               "%s takes optional counts of producers, consumers and strings",
+               argv[0]);
+        return false;
+    }
+
+    struct mpmc_run run = {.n = n};
+    struct mpmc_worker w[MAX_MPMC_THREADS] = {0};
+    int k = producers + consumers;
+    bool ok = true;
+
+    for (int i = 0; i < producers; i++) {
+        w[i].begin = (int) ((int64_t) n * i / producers);
+        w[i].end = (int) ((int64_t) n * (i + 1) / producers);
+    }
+
+    run.strs = malloc((size_t) n * MAX_RANDSTR_LEN);
+    run.q = mpmc_new(1024);
+    for (int i = 0; ok && i < k; i++) {
+        int ops = i < producers ? w[i].end - w[i].begin : n;
+        w[i].run = &run;
+        w[i].lat = malloc(((size_t) ops + 1) * sizeof(uint32_t));
+        ok = w[i].lat;
+    }
+    if (!ok || !run.strs || !run.q) {
+        report(1, "ERROR: Could not allocate the queue and the strings");
+        ok = false;
+        goto out;
+    }
+
+    uint64_t expect = 0;
+    for (int i = 0; i < n; i++) {
+        char *s = run.strs + (size_t) i * MAX_RANDSTR_LEN;
+        fill_rand_string(s, MAX_RANDSTR_LEN);
+        expect += mpmc_hash(s);
+    }
+
+    /* Consumers are started first and never stop while strings are missing,
+     * so the strings of a producer that could not be started are inserted
+     * from here instead. If a consumer could not be started, the others are
+     * told that there is nothing to wait for.
+     */
+    double t = 0;
+    init_time(&t);
+    bool started[MAX_MPMC_THREADS] = {false};
+    for (int i = producers; i < k; i++) {
+        started[i] =
+            !pthread_create(&w[i].thread, NULL, mpmc_consumer, &w[i]);
+        if (!started[i]) {
+            report(1, "ERROR: Could not start consumer thread");
+            atomic_store(&run.n, 0);
+            ok = false;
+            break;
+        }
+    }
+    for (int i = 0; ok && i < producers; i++) {
+        started[i] =
+            !pthread_create(&w[i].thread, NULL, mpmc_producer, &w[i]);
+        if (!started[i])
+            mpmc_producer(&w[i]);
+    }
+    for (int i = 0; i < k; i++) {
+        if (started[i])
+            pthread_join(w[i].thread, NULL);
+    }
+    double elapsed = delta_time(&t);
+    if (!ok)
+        goto out;
+
+    uint64_t sum = 0;
+    for (int i = producers; i < k; i++)
+        sum += w[i].checksum;
+    if (sum != expect || atomic_load(&run.removed) != n) {
+        report(1, "ERROR: Consumers did not remove each string exactly once");
+        ok = false;
+    }
+
+    if (ok) {
+        report(1,
+               "%d producers, %d consumers, %d strings: %.3f s, %.2f Mops/s",
+               producers, consumers, n, elapsed, 2e-6 * n / elapsed);
+        mpmc_report("Insert", w, producers, n);
+        mpmc_report("Remove", w + producers, consumers, n);
+    }
+
+out:
+    for (int i = 0; i < k; i++)
+        free(w[i].lat);
+    mpmc_free(run.q);
+    free(run.strs);
+    return ok && !error_check();
+}
+
+/* State of the two threads of the spsc command */
+struct spsc_run {
+    spsc_t *q;
+    char *strs;    /* strings to pass, MAX_RANDSTR_LEN bytes apart */
+    int n;         /* number of strings */
+    int64_t *sent; /* cycle count when each string was inserted */
+};
+
+/* Insert every string, stamped right before the attempt that succeeds. The
+ * stamp is written before the insertion publishes the string, so it is
+ * visible to the consumer by the time the string is.
+ */
+static void *spsc_producer(void *arg)
+{
+    struct spsc_run *run = arg;
+
+    for (int i = 0; i < run->n; i++) {
+        const char *s = run->strs + (size_t) i * MAX_RANDSTR_LEN;
+        for (;;) {
+            run->sent[i] = cpucycles();
+            if (spsc_insert_tail(run->q, s))
+                break;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static bool do_spsc(int argc, char *argv[])
+{
+    int n = 1000000;
+    if (argc > 2 || (argc == 2 && (!get_int(argv[1], &n) || n < 1))) {
+        report(1, "%s takes an optional positive count", argv[0]);
+        return false;
+    }
+
+    struct spsc_run run = {.n = n};
+    run.q = spsc_new(1024, MAX_RANDSTR_LEN);
+    run.strs = malloc((size_t) n * MAX_RANDSTR_LEN);
+    run.sent = malloc((size_t) n * sizeof(int64_t));
+    uint32_t *lat = malloc((size_t) n * sizeof(uint32_t));
+    bool ok = run.q && run.strs && run.sent && lat;
+    if (!ok) {
+        report(1, "ERROR: Could not allocate the queue and the strings");
+        goto out;
+    }
+
+    for (int i = 0; i < n; i++)
+        fill_rand_string(run.strs + (size_t) i * MAX_RANDSTR_LEN,
+                         MAX_RANDSTR_LEN);
+
+    pthread_t producer;
+    double t = 0;
+    init_time(&t);
+    if (pthread_create(&producer, NULL, spsc_producer, &run)) {
+        report(1, "ERROR: Could not start producer thread");
+        ok = false;
+        goto out;
+    }
+
+    /* Consume on this thread. The latency of a string runs from the moment
+     * the producer inserted it until it was removed here, so it includes the
+     * time it spent queued.
+     */
+    char buf[MAX_RANDSTR_LEN];
+    for (int i = 0; i < n; i++) {
+        while (!spsc_remove_head(run.q, buf, sizeof(buf)))
+            sched_yield();
+        int64_t cycles = cpucycles() - run.sent[i];
+        lat[i] = cycles < UINT32_MAX ? cycles : UINT32_MAX;
+        if (ok && strcmp(buf, run.strs + (size_t) i * MAX_RANDSTR_LEN)) {
+            report(1, "ERROR: String %d arrived out of order", i);
+            ok = false;
+        }
+    }
+    pthread_join(producer, NULL);
+    double elapsed = delta_time(&t);
+
+    if (ok) {
+        report(1, "%d strings: %.3f s, %.2f M messages/s", n, elapsed,
+               1e-6 * n / elapsed);
+        report_latency("Insert to remove", lat, n, "cycles");
+    }
+
+out:
+    spsc_free(run.q);
+    free(run.strs);
+    free(run.sent);
+    free(lat);
+    return ok && !error_check();
+}
+
 static bool do_merge(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -862,7 +1660,7 @@ static bool do_merge(int argc, char *argv[])
     exception_cancel();
     set_noallocate_mode(false);
 
-    if (q_size(&chain.head) > 1) {
+    if (chain.size > 1) {
         chain.size = 1;
         current = list_entry(chain.head.next, queue_contex_t, chain);
         current->size = len;
@@ -1056,6 +1854,201 @@ static bool do_next(int argc, char *argv[])
     return q_show(0);
 }
 
+static void set_sort_algo(int oldval)
+{
+    if (!q_sort_set_algo(sort_algo)) {
+        report(1, "Unknown sort algorithm %d, keeping %d", sort_algo, oldval);
+        sort_algo = oldval;
+    }
+}
+
+static void set_sort_threads(int oldval)
+{
+    if (!q_sort_set_threads(sort_threads)) {
+        report(1, "Invalid number of sort threads %d, keeping %d",
+               sort_threads, oldval);
+        sort_threads = oldval;
+    }
+}
+
+static void set_poison(int oldval)
+{
+    if (poison_interval < 0) {
+        report(1, "Invalid poison interval %d, keeping %d", poison_interval,
+               oldval);
+        poison_interval = oldval;
+    }
+}
+
+/* Shared state of the threads of the harness command */
+struct harness_run {
+    int n;              /* blocks allocated by each thread */
+    int n_threads;      /* threads of the run */
+    _Atomic int ready;  /* threads done allocating their blocks */
+    _Atomic bool abort; /* some thread could not be started */
+};
+
+/* A thread of the harness command, with the time of its two phases */
+struct harness_worker {
+    pthread_t thread;
+    struct harness_run *run;
+    void **blocks;                /* blocks allocated by this thread */
+    struct harness_worker *next;  /* thread whose blocks this one frees */
+    uint64_t cross_ns, own_ns;
+    bool error;
+};
+
+/* Allocate blocks, free those of the next thread once every thread has
+ * allocated its own, then time malloc/free pairs that stay in this thread
+ */
+static void *harness_worker(void *arg)
+{
+    struct harness_worker *w = arg;
+    struct harness_run *run = w->run;
+    int n = run->n;
+
+    for (int i = 0; i < n; i++)
+        w->blocks[i] = test_malloc(16 + i % 48);
+    atomic_fetch_add(&run->ready, 1);
+    while (atomic_load(&run->ready) < run->n_threads &&
+           !atomic_load(&run->abort))
+        sched_yield();
+
+    /* Without every thread running, each one frees its own blocks */
+    void **blocks = atomic_load(&run->abort) ? w->blocks : w->next->blocks;
+    uint64_t t = now_ns();
+    for (int i = 0; i < n; i++)
+        test_free(blocks[i]);
+    w->cross_ns = now_ns() - t;
+
+    t = now_ns();
+    for (int i = 0; i < n; i++)
+        test_free(test_malloc(32));
+    w->own_ns = now_ns() - t;
+
+    w->error = error_check();
+    return NULL;
+}
+
+static bool do_harness(int argc, char *argv[])
+{
+    int k = 4, n = 100000;
+    if (argc > 3 || (argc > 1 && !get_int(argv[1], &k)) ||
+        (argc > 2 && !get_int(argv[2], &n)) || k < 1 ||
+        k > MAX_MPMC_THREADS || n < 1) {
+        report(1, "%s takes optional counts of threads and blocks", argv[0]);
+        return false;
+    }
+
+    struct harness_run run = {.n = n, .n_threads = k};
+    struct harness_worker w[MAX_MPMC_THREADS] = {0};
+    bool ok = true;
+
+    for (int i = 0; ok && i < k; i++) {
+        w[i].run = &run;
+        w[i].next = &w[(i + 1) % k];
+        w[i].blocks = malloc((size_t) n * sizeof(void *));
+        ok = w[i].blocks;
+    }
+    if (!ok) {
+        report(1, "ERROR: Could not allocate the arrays of blocks");
+        goto out;
+    }
+
+    error_check();
+    size_t live = allocation_check();
+    bool started[MAX_MPMC_THREADS] = {false};
+    for (int i = 0; i < k; i++) {
+        started[i] = !pthread_create(&w[i].thread, NULL, harness_worker, &w[i]);
+        if (!started[i]) {
+            report(1, "ERROR: Could not start thread");
+            atomic_store(&run.abort, true);
+            ok = false;
+            break;
+        }
+    }
+    for (int i = 0; i < k; i++) {
+        if (started[i])
+            pthread_join(w[i].thread, NULL);
+    }
+    if (!ok)
+        goto out;
+
+    uint64_t cross = 0, own = 0;
+    for (int i = 0; i < k; i++) {
+        if (w[i].error) {
+            report(1, "ERROR: The harness reported an error in thread %d", i);
+            ok = false;
+        }
+        cross = w[i].cross_ns > cross ? w[i].cross_ns : cross;
+        own = w[i].own_ns > own ? w[i].own_ns : own;
+    }
+    if (allocation_check() != live) {
+        report(1, "ERROR: Blocks were lost or freed twice");
+        ok = false;
+    }
+
+    if (ok) {
+        report(1,
+               "%d threads, %d blocks each: free from another thread "
+               "%.2f Mops/s, malloc/free in the same thread %.2f Mops/s",
+               k, n, 1e3 * k * n / (cross ? cross : 1),
+               2e3 * k * n / (own ? own : 1));
+    }
+
+out:
+    for (int i = 0; i < k; i++)
+        free(w[i].blocks);
+    return ok && !error_check();
+}
+
+/* Write to a freed block on purpose, and check that the harness reports it
+ * without waiting for the block to be pushed out of quarantine
+ */
+static bool do_uaf(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+
+    /* The block must be poisoned and stay in quarantine, or it would really
+     * be back in malloc by the time it is written
+     */
+    error_check();
+    int interval = poison_interval, size = quarantine_size;
+    poison_interval = 1;
+    quarantine_size = INT_MAX;
+    char *p = test_malloc(16);
+    if (p)
+        test_free(p);
+    poison_interval = interval;
+    quarantine_size = size;
+    if (!p) {
+        report(1, "ERROR: Could not allocate the block");
+        return false;
+    }
+
+    // cppcheck-suppress deallocuse
+    p[0] = 'x';
+    allocation_check();
+    if (!error_check()) {
+        report(1, "ERROR: Write after free was not reported");
+        return false;
+    }
+    report(1, "Write after free was reported");
+    return true;
+}
+
+static void set_quarantine(int oldval)
+{
+    if (quarantine_size < 0) {
+        report(1, "Invalid quarantine size %d, keeping %d", quarantine_size,
+               oldval);
+        quarantine_size = oldval;
+    }
+}
+
 static void console_init()
 {
     ADD_COMMAND(new, "Create new queue", "");
@@ -1070,10 +2063,11 @@ static void console_init()
                 "Insert string str at tail of queue n times. Generate random "
                 "string(s) if str equals RAND. (default: n == 1)",
                 "str [n]");
-    ADD_COMMAND(
-        rh,
-        "Remove from head of queue. Optionally compare to expected value str",
-        "[str]");
+    ADD_COMMAND(rh,
+                "Remove from head of queue. Optionally compare to expected "
+                "value str",
+                "[str]");
+    ADD_COMMAND(rhn, "Remove n elements from head of queue at once", "n");
     ADD_COMMAND(
         rt,
         "Remove from tail of queue. Optionally compare to expected value str",
@@ -1082,8 +2076,16 @@ static void console_init()
     ADD_COMMAND(sort, "Sort queue in ascending/descening order", "");
     ADD_COMMAND(size, "Compute queue size n times (default: n == 1)", "[n]");
     ADD_COMMAND(show, "Show queue contents", "");
+    ADD_COMMAND(find,
+                "Count the nodes holding str n times (default: n == 1), "
+                "through a hash index built on first use and rebuilt in "
+                "linear time after a merge",
+                "str [n]");
     ADD_COMMAND(dm, "Delete middle node in queue", "");
-    ADD_COMMAND(dedup, "Delete all nodes that have duplicate string", "");
+    ADD_COMMAND(dedup,
+                "Delete all nodes that have duplicate string, also when "
+                "not adjacent if 'all' is given",
+                "[all]");
     ADD_COMMAND(merge, "Merge all the queues into one sorted queue", "");
     ADD_COMMAND(swap, "Swap every two adjacent nodes in queue", "");
     ADD_COMMAND(ascend,
@@ -1096,14 +2098,51 @@ static void console_init()
                 "");
     ADD_COMMAND(reverseK, "Reverse the nodes of the queue 'K' at a time",
                 "[K]");
+    ADD_COMMAND(mpmc,
+                "Pass n strings from p producers to c consumers through a "
+                "lock-free queue (default: 4 4 1000000)",
+                "[p] [c] [n]");
+    ADD_COMMAND(spsc,
+                "Pass n strings from a producer to a consumer thread through "
+                "a wait-free ring (default: n == 1000000)",
+                "[n]");
+    ADD_COMMAND(ring,
+                "Compare n FIFO and LIFO operations on a queue and on a ring "
+                "buffer (default: n == 1000000)",
+                "[n]");
+    ADD_COMMAND(harness,
+                "Allocate n blocks in each of t threads through the test "
+                "harness, freeing them from another thread (default: 4 100000)",
+                "[t] [n]");
+    ADD_COMMAND(uaf,
+                "Write to a freed block, checking that the harness reports it",
+                "");
     add_param("length", &string_length, "Maximum length of displayed string",
               NULL);
     add_param("malloc", &fail_probability, "Malloc failure probability percent",
               NULL);
     add_param("fail", &fail_limit,
               "Number of times allow queue operations to return false", NULL);
+    add_param("timelimit", &time_limit,
+              "Number of seconds allowed for each queue operation", NULL);
+    add_param("poison", &poison_interval,
+              "Fill every Nth block on malloc and free, 0 for canaries only",
+              set_poison);
+    add_param("quarantine", &quarantine_size,
+              "Bytes of poisoned blocks kept from reuse after free",
+              set_quarantine);
     add_param("descend", &descend,
               "Sort and merge queue in ascending/descending order", NULL);
+    add_param("pool", &use_pool,
+              "Allocate elements of new queues from a node pool", NULL);
+    add_param("intern", &use_intern,
+              "Share the strings of equal elements of new queues", NULL);
+    add_param("sortalgo", &sort_algo,
+              "Sort algorithm: 0 for merge sort, 1 for radix sort",
+              set_sort_algo);
+    add_param("sortthreads", &sort_threads,
+              "Threads used to sort large queues, 0 for one per CPU",
+              set_sort_threads);
 }
 
 /* Signal handlers */
@@ -1136,9 +2175,6 @@ static void q_init()
 static bool q_quit(int argc, char *argv[])
 {
     report(3, "Freeing queue");
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
-
     if (exception_setup(true)) {
         struct list_head *cur = chain.head.next;
         while (chain.size > 0) {
@@ -1151,7 +2187,6 @@ static bool q_quit(int argc, char *argv[])
     }
 
     exception_cancel();
-    set_cautious_mode(true);
 
     size_t bcnt = allocation_check();
     if (bcnt > 0) {
@@ -1160,7 +2195,7 @@ static bool q_quit(int argc, char *argv[])
         return false;
     }
 
-    return true;
+    return !error_check();
 }
 
 static void usage(char *cmd)
@@ -1,8 +1,13 @@
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "queue.h"
+#include "report.h"
 
 /* Notice: sometimes, Cppcheck would find the potential NULL pointer bugs,
  * but some of them cannot occur. You can suppress them by adding the
@@ -10,20 +15,520 @@
  *   cppcheck-suppress nullPointer
  */
 
-void merge_two_list(struct list_head *L1, struct list_head *L2);
+/* Map the list head handed out by q_new() back to its queue header */
+static inline queue_t *to_queue(struct list_head *head)
+{
+    return container_of(head, queue_t, head);
+}
+
+/* Strings of up to INLINE_MAX bytes, terminator included, are stored in the
+ * same allocation as their element, right behind it in @inline_value. Longer
+ * ones get a heap block of their own.
+ */
+#define INLINE_SHIFT 3
+#define INLINE_CLASSES 5
+#define INLINE_MAX (1U << (INLINE_SHIFT + INLINE_CLASSES - 1))
+
+/* Node pool
+ *
+ * Class 0 of a pool serves bare element_t nodes for long strings, class i > 0
+ * serves elements with 8 << (i - 1) bytes of inline string storage. Each
+ * class is refilled with slabs of geometrically growing size and keeps
+ * released objects on a free list linked through their first word. Slabs are
+ * only handed back to the heap when the pool is destroyed, which happens once
+ * the owning queue is freed and no element carved from the pool is left
+ * anywhere else (q_merge() can move elements to the queue of another pool).
+ */
+#define POOL_SLAB_MIN 32
+#define POOL_SLAB_MAX 4096
+
+typedef struct pool_slab {
+    struct pool_slab *next;
+} pool_slab_t;
+
+typedef struct {
+    size_t objsize;
+    size_t nobjs;    /* objects in the next slab */
+    void *free;      /* released objects */
+    char *cur, *end; /* unused part of the newest slab */
+} pool_class_t;
+
+struct q_pool {
+    pool_class_t class[1 + INLINE_CLASSES];
+    pool_slab_t *slabs;
+    size_t live;     /* elements handed out and not yet released */
+    size_t heap_str; /* live elements whose string is not inline */
+    bool orphan;     /* the owning queue has been freed */
+};
+
+/* Return the class for a string of @size bytes, 0 if it cannot be inline */
+static int inline_class(size_t size)
+{
+    if (size > INLINE_MAX)
+        return 0;
+
+    int idx = 1;
+    for (size_t cap = 1U << INLINE_SHIFT; cap < size; cap <<= 1)
+        idx++;
+    return idx;
+}
+
+static inline size_t inline_capacity(int idx)
+{
+    return idx ? 1U << (INLINE_SHIFT + idx - 1) : 0;
+}
+
+static void *pool_alloc(struct q_pool *pool, int idx)
+{
+    pool_class_t *c = &pool->class[idx];
+    void *obj = c->free;
+
+    if (obj) {
+        c->free = *(void **) obj;
+        return obj;
+    }
+
+    if (c->cur == c->end) {
+        pool_slab_t *slab = malloc(sizeof(pool_slab_t) + c->nobjs * c->objsize);
+        if (!slab)
+            return NULL;
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        c->cur = (char *) (slab + 1);
+        c->end = c->cur + c->nobjs * c->objsize;
+        if (c->nobjs < POOL_SLAB_MAX)
+            c->nobjs <<= 1;
+    }
+
+    obj = c->cur;
+    c->cur += c->objsize;
+    return obj;
+}
+
+static inline void pool_free(struct q_pool *pool, int idx, void *obj)
+{
+    *(void **) obj = pool->class[idx].free;
+    pool->class[idx].free = obj;
+}
+
+static void pool_destroy(struct q_pool *pool)
+{
+    pool_slab_t *slab = pool->slabs;
+    while (slab) {
+        pool_slab_t *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(pool);
+}
+
+/* Keep @mid at index size / 2 after @n elements were linked in at the front
+ * or the back, @size already counting them. Inserting at the front shifts the
+ * old middle node up by @n. It takes about @n / 2 steps, at most one for a
+ * single element.
+ */
+static inline void mid_inserted(queue_t *queue, size_t n, bool front)
+{
+    struct list_head *mid = queue->mid;
+    if (!mid)
+        return;
+
+    size_t old = queue->size - n, target = queue->size / 2;
+    if (!old) {
+        for (mid = queue->head.next; target; target--)
+            mid = mid->next;
+    } else if (front) {
+        for (size_t i = old / 2 + n; i > target; i--)
+            mid = mid->prev;
+    } else {
+        for (size_t i = old / 2; i < target; i++)
+            mid = mid->next;
+    }
+    queue->mid = mid;
+}
+
+/* Keep @mid at index size / 2 across the removal of the front or back
+ * element, called while @size still counts it
+ */
+static inline void mid_removing(queue_t *queue, bool front)
+{
+    if (!queue->mid)
+        return;
+
+    if (queue->size == 1)
+        queue->mid = &queue->head;
+    else if (front && (queue->size & 1))
+        queue->mid = queue->mid->next;
+    else if (!front && !(queue->size & 1))
+        queue->mid = queue->mid->prev;
+}
+
+/* Pack the first 8 bytes of @s into an integer that sorts like the string */
+static inline uint64_t key_prefix(const char *s)
+{
+    uint64_t key = 0;
+
+    for (int i = 0; i < 8 && s[i]; i++)
+        key |= (uint64_t) (unsigned char) s[i] << (56 - 8 * i);
+    return key;
+}
+
+/* strcmp() on the values of two elements, settled by their key prefixes
+ * unless those are equal. Equal keys whose last byte is zero belong to two
+ * strings that both end within the prefix, so the strings are equal too.
+ */
+static inline int value_cmp(const element_t *a, const element_t *b)
+{
+    if (a->key != b->key)
+        return a->key < b->key ? -1 : 1;
+    if (!(a->key & 0xff))
+        return 0;
+    return strcmp(a->value + 8, b->value + 8);
+}
+
+/* Hash string @s whose key prefix is @key */
+static inline uint64_t string_hash(uint64_t key, const char *s)
+{
+    uint64_t h = key;
+
+    /* A key without a NUL byte did not cover the whole string */
+    if (key & 0xff) {
+        for (const unsigned char *p = (const unsigned char *) s + 8; *p; p++)
+            h = (h ^ *p) * 0x100000001b3ULL;
+    }
+
+    /* Finalizer of MurmurHash3, so that the low bits depend on every byte */
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* Hash the string of @e, starting from the key prefix it already holds */
+static inline uint64_t value_hash(const element_t *e)
+{
+    return string_hash(e->key, e->value);
+}
+
+/* Hash index of the values of a queue
+ *
+ * An open-addressing table with linear probing, kept at most half full, with
+ * one slot per distinct string. A slot owns a copy of its string and counts
+ * the elements holding it, so that removing one of many equal elements does
+ * not have to search among them. Deletion shifts the following slots of the
+ * cluster back instead of leaving tombstones. The memory comes from
+ * malloc_or_fail() and friends, which count it in report.c.
+ *
+ * q_merge() must not allocate, so it only marks the indexes of the queues
+ * it moves elements between as stale. A stale index ignores links and
+ * unlinks, and the next q_find() rebuilds it from the elements.
+ */
+#define INDEX_MIN_CAPACITY 16
+
+struct index_slot {
+    char *value;   /* copy of the string, NULL if the slot is unused */
+    uint64_t hash; /* hash of @value */
+    int count;     /* elements holding @value */
+};
+
+struct q_index {
+    struct index_slot *slot;
+    size_t mask; /* capacity minus one */
+    size_t used; /* slots in use */
+    bool stale;  /* counts out of date until rebuilt */
+};
+
+/* Find the slot of the string @s with hash @h, or the unused slot ending its
+ * probe sequence
+ */
+static size_t index_probe(const struct q_index *index,
+                          const char *s,
+                          uint64_t h)
+{
+    size_t i = h & index->mask;
+
+    while (index->slot[i].value &&
+           (index->slot[i].hash != h || strcmp(index->slot[i].value, s)))
+        i = (i + 1) & index->mask;
+    return i;
+}
+
+/* Move the strings of @index to @slot, an empty table of @cap slots, and
+ * return the old table
+ */
+static struct index_slot *index_rehash(struct q_index *index,
+                                       struct index_slot *slot,
+                                       size_t cap)
+{
+    struct index_slot *old = index->slot;
+    size_t old_cap = index->mask + 1;
+
+    index->slot = slot;
+    index->mask = cap - 1;
+    for (size_t i = 0; old && i < old_cap; i++) {
+        if (!old[i].value)
+            continue;
+        size_t j = old[i].hash & index->mask;
+        while (slot[j].value)
+            j = (j + 1) & index->mask;
+        slot[j] = old[i];
+    }
+    return old;
+}
+
+/* Double the capacity of the table of @index */
+static void index_grow(struct q_index *index)
+{
+    size_t cap = index->mask + 1;
+    struct index_slot *slot =
+        calloc_or_fail(cap << 1, sizeof(struct index_slot), "q_index");
+
+    free_array(index_rehash(index, slot, cap << 1), cap,
+               sizeof(struct index_slot));
+}
+
+/* Empty slot @i of @index, whose string has been released
+ *
+ * Every later slot of the cluster that may live at @i, that is whose home is
+ * no closer to it than @i, is pulled back, so no tombstone is needed.
+ */
+static void index_unlink(struct q_index *index, size_t i)
+{
+    index->used--;
+    for (size_t j = (i + 1) & index->mask; index->slot[j].value;
+         j = (j + 1) & index->mask) {
+        size_t home = index->slot[j].hash & index->mask;
+        if (((j - home) & index->mask) >= ((j - i) & index->mask)) {
+            index->slot[i] = index->slot[j];
+            i = j;
+        }
+    }
+    index->slot[i].value = NULL;
+}
+
+/* Count element @e in the index of @queue, if it has one */
+static inline void index_add(queue_t *queue, const element_t *e)
+{
+    struct q_index *index = queue->index;
+    if (!index || index->stale)
+        return;
+
+    uint64_t h = value_hash(e);
+    size_t i = index_probe(index, e->value, h);
+    if (index->slot[i].value) {
+        index->slot[i].count++;
+        return;
+    }
+
+    if (2 * (index->used + 1) > index->mask + 1) {
+        index_grow(index);
+        i = index_probe(index, e->value, h);
+    }
+    index->slot[i] = (struct index_slot){
+        strsave_or_fail(e->value, "q_index"),
+        h,
+        1,
+    };
+    index->used++;
+}
+
+/* Uncount element @e in the index of @queue, if it has one */
+static inline void index_del(queue_t *queue, const element_t *e)
+{
+    struct q_index *index = queue->index;
+    if (!index || index->stale)
+        return;
+
+    size_t i = index_probe(index, e->value, value_hash(e));
+    if (!index->slot[i].value || --index->slot[i].count)
+        return;
+
+    free_string(index->slot[i].value);
+    index_unlink(index, i);
+}
+
+/* Drop every string from the index of @queue, if it has one */
+static void index_clear(queue_t *queue)
+{
+    struct q_index *index = queue->index;
+    if (!index || !index->used)
+        return;
+
+    for (size_t i = 0; i <= index->mask; i++) {
+        if (index->slot[i].value) {
+            free_string(index->slot[i].value);
+            index->slot[i].value = NULL;
+        }
+    }
+    index->used = 0;
+}
+
+/* Table of interned strings, shared by every queue in interning mode
+ *
+ * It uses the layout of a hash index, but the strings it holds are the very
+ * bytes the elements point to, and the count of a slot is the number of
+ * elements referring to them. Unlike an index, its memory comes from the
+ * allocator checked by the test harness, and the table itself is freed once
+ * the last string is released.
+ */
+static struct q_index interned;
+
+/* Return a reference to the interned copy of @s, whose key prefix is @key,
+ * or NULL if allocation failed
+ */
+static char *intern_get(const char *s, uint64_t key)
+{
+    uint64_t h = string_hash(key, s);
+
+    if (interned.slot) {
+        size_t i = index_probe(&interned, s, h);
+        if (interned.slot[i].value) {
+            interned.slot[i].count++;
+            return interned.slot[i].value;
+        }
+    }
+
+    /* Copy the string first, so that a failure leaves no empty table */
+    char *value = strdup(s);
+    if (!value)
+        return NULL;
+
+    size_t cap = interned.slot ? interned.mask + 1 : 0;
+    if (2 * (interned.used + 1) > cap) {
+        size_t new_cap = cap ? cap << 1 : INDEX_MIN_CAPACITY;
+        struct index_slot *slot = calloc(new_cap, sizeof(struct index_slot));
+        if (!slot) {
+            free(value);
+            return NULL;
+        }
+        free(index_rehash(&interned, slot, new_cap));
+    }
+
+    interned.slot[index_probe(&interned, s, h)] =
+        (struct index_slot){value, h, 1};
+    interned.used++;
+    return value;
+}
+
+/* Drop the reference of @e to its string if that string is interned
+ *
+ * Return: false if the string of @e is a private copy
+ */
+static bool intern_put(const element_t *e)
+{
+    if (!interned.used)
+        return false;
+
+    size_t i = index_probe(&interned, e->value, value_hash(e));
+    if (interned.slot[i].value != e->value)
+        return false;
+
+    if (!--interned.slot[i].count) {
+        free(e->value);
+        index_unlink(&interned, i);
+        if (!interned.used) {
+            free(interned.slot);
+            interned.slot = NULL;
+        }
+    }
+    return true;
+}
+
+/* Allocate an element holding a copy of @s, from the pool of @queue if any.
+ * In interning mode, the element refers to the shared copy of @s instead.
+ */
+static element_t *element_new(queue_t *queue, const char *s)
+{
+    struct q_pool *pool = queue->pool;
+    size_t len = strlen(s) + 1;
+    int idx = queue->intern ? 0 : inline_class(len);
+
+    element_t *item = pool ? pool_alloc(pool, idx)
+                           : malloc(sizeof(element_t) + (idx ? len : 0));
+    if (!item)
+        return NULL;
+
+    item->key = key_prefix(s);
+    if (idx) {
+        item->value = item->inline_value;
+        memcpy(item->value, s, len);
+    } else {
+        item->value = queue->intern ? intern_get(s, item->key) : malloc(len);
+        if (!item->value) {
+            if (pool)
+                pool_free(pool, 0, item);
+            else
+                free(item);
+            return NULL;
+        }
+        if (!queue->intern)
+            memcpy(item->value, s, len);
+    }
+
+    item->pool = pool;
+    if (pool) {
+        pool->live++;
+        if (!idx)
+            pool->heap_str++;
+    }
+    return item;
+}
+
+/* Release an element, handing pooled storage back to its pool and interned
+ * strings back to the intern table
+ */
+void q_release_element(element_t *e)
+{
+    struct q_pool *pool = e->pool;
+    bool heap_str = e->value != e->inline_value;
+    int idx = 0;
+
+    if (!heap_str)
+        idx = inline_class(strlen(e->value) + 1);
+    else if (!intern_put(e))
+        free(e->value);
+
+    if (!pool) {
+        free(e);
+        return;
+    }
+
+    if (heap_str)
+        pool->heap_str--;
+    pool_free(pool, idx, e);
+
+    if (!--pool->live && pool->orphan)
+        pool_destroy(pool);
+}
 
 /* Create an empty queue */
 struct list_head *q_new()
 {
-    struct list_head *queue = malloc(sizeof(struct list_head));
+    queue_t *queue = malloc(sizeof(queue_t));
 
     if (!queue) {
         return NULL;
     }
 
-    INIT_LIST_HEAD(queue);
-
-    return queue;
+    INIT_LIST_HEAD(&queue->head);
+    queue->size = 0;
+    queue->pool = NULL;
+    queue->mixed = false;
+    queue->mid = &queue->head;
+    queue->index = NULL;
+    queue->intern = false;
+
+#ifdef QUEUE_CHUNKED
+    /* Chunked backend: every queue carves its elements out of the slabs of a
+     * node pool, so that neighbours in the list are mostly neighbours in
+     * memory too. Without a pool the queue still works, one block per node.
+     */
+    q_pool_enable(&queue->head);
+#endif
+
+    return &queue->head;
 }
 
 /* Free all storage used by queue */
@@ -32,18 +537,136 @@ void q_free(struct list_head *head)
     if (!head)
         return;
 
-    struct list_head *cur = head->next;
+    queue_t *queue = to_queue(head);
+    struct q_pool *pool = queue->pool;
+
+    /* If every element the pool has handed out is still linked here, the
+     * slabs can be returned wholesale without visiting the elements.
+     */
+    if (pool && !queue->mixed && !pool->heap_str &&
+        pool->live == (size_t) queue->size) {
+        pool->live = 0;
+    } else {
+        element_t *item, *safe;
+        list_for_each_entry_safe (item, safe, head, list)
+            q_release_element(item);
+    }
 
-    while (cur != head) {
-        struct list_head *temp = cur;
-        cur = cur->next;
+    if (pool) {
+        pool->orphan = true;
+        if (!pool->live)
+            pool_destroy(pool);
+    }
+
+    if (queue->index) {
+        index_clear(queue);
+        free_array(queue->index->slot, queue->index->mask + 1,
+                   sizeof(struct index_slot));
+        free_block(queue->index, sizeof(struct q_index));
+    }
+
+    free(queue);
+}
+
+/* Allocate the elements of an empty queue from a node pool */
+bool q_pool_enable(struct list_head *head)
+{
+    if (!head || !list_empty(head))
+        return false;
+
+    queue_t *queue = to_queue(head);
+    if (queue->pool)
+        return true;
+
+    struct q_pool *pool = malloc(sizeof(struct q_pool));
+    if (!pool)
+        return false;
+
+    memset(pool, 0, sizeof(struct q_pool));
+    for (int i = 0; i <= INLINE_CLASSES; i++) {
+        pool->class[i].objsize = sizeof(element_t) + inline_capacity(i);
+        pool->class[i].nobjs = POOL_SLAB_MIN;
+    }
+
+    queue->pool = pool;
+    queue->mixed = false;
+    return true;
+}
+
+/* Share the strings of the elements of an empty queue through interning */
+bool q_intern_enable(struct list_head *head)
+{
+    if (!head || !list_empty(head))
+        return false;
+
+    /* Once the strings are shared, the nodes are all that is left to
+     * allocate per element, so take them from a node pool if possible
+     */
+    q_pool_enable(head);
+    to_queue(head)->intern = true;
+    return true;
+}
+
+/* Whether queue shares the strings of equal elements */
+bool q_interns(struct list_head *head)
+{
+    return head && to_queue(head)->intern;
+}
+
+/* Keep a hash index of the strings in queue */
+bool q_index_enable(struct list_head *head)
+{
+    if (!head)
+        return false;
 
-        element_t *item = container_of(temp, element_t, list);
-        free(item->value);
-        free(item);
+    queue_t *queue = to_queue(head);
+    if (queue->index)
+        return true;
+
+    size_t cap = INDEX_MIN_CAPACITY;
+    while (cap < 2 * (size_t) queue->size)
+        cap <<= 1;
+
+    struct q_index *index =
+        malloc_or_fail(sizeof(struct q_index), "q_index_enable");
+    index->slot = calloc_or_fail(cap, sizeof(struct index_slot), "q_index");
+    index->mask = cap - 1;
+    index->used = 0;
+    index->stale = false;
+    queue->index = index;
+
+    element_t *item;
+    list_for_each_entry (item, head, list)
+        index_add(queue, item);
+    return true;
+}
+
+/* Count the elements of queue holding @s */
+int q_find(struct list_head *head, const char *s)
+{
+    if (!head || !s)
+        return 0;
+
+    queue_t *queue = to_queue(head);
+    const struct q_index *index = queue->index;
+    if (index && index->stale) {
+        index_clear(queue);
+        queue->index->stale = false;
+        element_t *item;
+        list_for_each_entry (item, head, list)
+            index_add(queue, item);
+    }
+
+    if (index) {
+        size_t i = index_probe(index, s, string_hash(key_prefix(s), s));
+        return index->slot[i].value ? index->slot[i].count : 0;
     }
 
-    free(head);
+    int count = 0;
+    element_t *item;
+    list_for_each_entry (item, head, list)
+        count += !strcmp(item->value, s);
+    return count;
 }
 
 /* Insert an element at head of queue */
@@ -52,17 +675,14 @@ bool q_insert_head(struct list_head *head, char *s)
     if (!head)
         return false;
 
-    element_t *item = malloc(sizeof(element_t));
+    element_t *item = element_new(to_queue(head), s);
     if (!item)
         return false;
 
-    item->value = strdup(s);
-    if (!item->value) {
-        free(item);
-        return false;
-    }
-
     list_add(&item->list, head);
+    to_queue(head)->size++;
+    mid_inserted(to_queue(head), 1, true);
+    index_add(to_queue(head), item);
     return true;
 }
 
@@ -72,21 +692,125 @@ bool q_insert_tail(struct list_head *head, char *s)
     if (!head)
         return false;
 
-    element_t *item = malloc(sizeof(element_t));
-    if (!item) {
+    element_t *item = element_new(to_queue(head), s);
+    if (!item)
         return false;
-    }
 
-    item->value = strdup(s);
-    if (!item->value) {
-        free(item);
+    list_add_tail(&item->list, head);
+    to_queue(head)->size++;
+    mid_inserted(to_queue(head), 1, false);
+    index_add(to_queue(head), item);
+    return true;
+}
+
+/* Size of an element of a bulk block holding a string of @len bytes */
+static inline size_t bulk_objsize(size_t len)
+{
+    return (sizeof(element_t) + len + 7) & ~(size_t) 7;
+}
+
+/* Insert the @n strings found @stride bytes apart from @s, in one splice
+ *
+ * Without a node pool, the elements are carved out of a single block that
+ * starts with a q_pool of its own. That pool never allocates: it only counts
+ * the live elements of the block, and being orphaned from the start, it frees
+ * the block together with the last of them. Every string, however long, is
+ * stored inline. With a node pool or in interning mode, the elements are
+ * allocated one by one as usual. Either way the chain is built privately, so
+ * that a failure leaves the queue untouched.
+ */
+static bool insert_bulk(struct list_head *head,
+                        const char *s,
+                        size_t stride,
+                        size_t n,
+                        bool tail)
+{
+    if (!head || !s)
         return false;
+    if (!n)
+        return true;
+
+    queue_t *queue = to_queue(head);
+    LIST_HEAD(chain);
+
+    if (queue->pool || queue->intern) {
+        for (size_t i = 0; i < n; i++) {
+            element_t *item = element_new(queue, s + i * stride);
+            if (!item) {
+                element_t *safe;
+                list_for_each_entry_safe (item, safe, &chain, list)
+                    q_release_element(item);
+                return false;
+            }
+            if (tail)
+                list_add_tail(&item->list, &chain);
+            else
+                list_add(&item->list, &chain);
+        }
+    } else {
+        size_t total = sizeof(struct q_pool);
+        for (size_t i = 0; i < n; i++)
+            total += bulk_objsize(strlen(s + i * stride) + 1);
+
+        struct q_pool *block = malloc(total);
+        if (!block)
+            return false;
+
+        memset(block, 0, sizeof(struct q_pool));
+        block->live = n;
+        block->orphan = true;
+
+        char *obj = (char *) (block + 1);
+        for (size_t i = 0; i < n; i++) {
+            const char *str = s + i * stride;
+            size_t len = strlen(str) + 1;
+            element_t *item = (element_t *) obj;
+
+            item->value = item->inline_value;
+            memcpy(item->value, str, len);
+            item->key = key_prefix(str);
+            item->pool = block;
+            if (tail)
+                list_add_tail(&item->list, &chain);
+            else
+                list_add(&item->list, &chain);
+            obj += bulk_objsize(len);
+        }
     }
 
-    list_add_tail(&item->list, head);
+    if (queue->index) {
+        element_t *item;
+        list_for_each_entry (item, &chain, list)
+            index_add(queue, item);
+    }
+
+    if (tail)
+        list_splice_tail(&chain, head);
+    else
+        list_splice(&chain, head);
+    queue->size += n;
+    mid_inserted(queue, n, !tail);
     return true;
 }
 
+/* Insert several elements at head of queue */
+bool q_insert_head_bulk(struct list_head *head,
+                        const char *s,
+                        size_t stride,
+                        size_t n)
+{
+    return insert_bulk(head, s, stride, n, false);
+}
+
+/* Insert several elements at tail of queue */
+bool q_insert_tail_bulk(struct list_head *head,
+                        const char *s,
+                        size_t stride,
+                        size_t n)
+{
+    return insert_bulk(head, s, stride, n, true);
+}
+
 /* Remove an element from head of queue */
 element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize)
 {
@@ -96,7 +820,10 @@ element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize)
     struct list_head *remove = head->next;
     element_t *re_item = container_of(remove, element_t, list);
 
+    mid_removing(to_queue(head), true);
     list_del(remove);
+    to_queue(head)->size--;
+    index_del(to_queue(head), re_item);
 
     if (sp != NULL) {
         strncpy(sp, re_item->value, bufsize - 1);
@@ -115,7 +842,10 @@ element_t *q_remove_tail(struct list_head *head, char *sp, size_t bufsize)
     struct list_head *remove = head->prev;
     element_t *re_item = container_of(remove, element_t, list);
 
+    mid_removing(to_queue(head), false);
     list_del(remove);
+    to_queue(head)->size--;
+    index_del(to_queue(head), re_item);
 
     if (sp != NULL) {
         strncpy(sp, re_item->value, bufsize - 1);
@@ -125,45 +855,93 @@ element_t *q_remove_tail(struct list_head *head, char *sp, size_t bufsize)
     return re_item;
 }
 
-/* Return number of elements in queue */
-int q_size(struct list_head *head)
+/* Remove up to @n elements from head of queue with a single cut */
+int q_remove_head_n(struct list_head *head,
+                    struct list_head *list,
+                    int n,
+                    char *sp,
+                    size_t bufsize)
 {
-    if (!head || head->next == head)
+    if (!list)
         return 0;
 
-    int count = 0;
-    struct list_head *temp = head->next;
-    while (temp != head) {
-        count++;
-        temp = temp->next;
+    INIT_LIST_HEAD(list);
+    if (!head || list_empty(head) || n <= 0)
+        return 0;
+
+    queue_t *queue = to_queue(head);
+    int count = n < queue->size ? n : queue->size;
+    struct list_head *cut = head;
+
+    if (sp && bufsize) {
+        /* Pack the strings back to back while they fit, truncating the
+         * first one that does not.
+         */
+        for (int i = 0; i < count; i++) {
+            cut = cut->next;
+            if (!bufsize)
+                continue;
+
+            const char *value = list_entry(cut, element_t, list)->value;
+            size_t len = strlen(value) + 1;
+            if (len > bufsize)
+                len = bufsize;
+            memcpy(sp, value, len - 1);
+            sp[len - 1] = '\0';
+            sp += len;
+            bufsize -= len;
+        }
+    } else if (count == queue->size) {
+        cut = head->prev;
+    } else {
+        for (int i = 0; i < count; i++)
+            cut = cut->next;
     }
 
+    list_cut_position(list, head, cut);
+    queue->size -= count;
+    queue->mid = NULL;
+
+    if (queue->index) {
+        element_t *item;
+        list_for_each_entry (item, list, list)
+            index_del(queue, item);
+    }
     return count;
 }
 
+/* Return number of elements in queue */
+int q_size(struct list_head *head)
+{
+    if (!head)
+        return 0;
+
+    return to_queue(head)->size;
+}
+
 /* Delete the middle node in queue */
 bool q_delete_mid(struct list_head *head)
 {
-    struct list_head *temp = head;
-
-    int count = q_size(head);
     if (!head)
         return false;
     if (list_empty(head))
         return true;
 
-    count = count / 2 + 1;
-    while (count != 1) {
-        temp = temp->next;
-        count -= 1;
+    queue_t *queue = to_queue(head);
+    struct list_head *mid = queue->mid;
+    if (!mid) {
+        mid = head->next;
+        for (int i = queue->size / 2; i > 0; i--)
+            mid = mid->next;
     }
-    element_t *re_item = container_of(temp->next, element_t, list);
 
-    temp->next->next->prev = temp;
-    temp->next = temp->next->next;
+    /* The new middle node is a neighbour of the deleted one */
+    queue->mid = (queue->size & 1) ? mid->next : mid->prev;
+    list_del(mid);
+    queue->size--;
+    index_del(queue, list_entry(mid, element_t, list));
 
-    free(re_item->value);
-    free(re_item);
+    q_release_element(list_entry(mid, element_t, list));
 
     return true;
 }
@@ -174,6 +952,8 @@ bool q_delete_dup(struct list_head *head)
     if (!head || list_empty(head))
         return false;
 
+    to_queue(head)->mid = NULL;
+
     struct list_head *cur = head->next;
 
     while (cur != head) {
@@ -184,12 +964,13 @@ bool q_delete_dup(struct list_head *head)
         while (temp != head) {
             element_t *node2 = container_of(temp, element_t, list);
 
-            if (strcmp(node1->value, node2->value) == 0) {
+            if (value_cmp(node1, node2) == 0) {
                 dup = true;
                 temp = temp->next;
                 list_del(&node2->list);
-                free(node2->value);
-                free(node2);
+                to_queue(head)->size--;
+                index_del(to_queue(head), node2);
+                q_release_element(node2);
             } else {
                 break;
             }
@@ -198,14 +979,81 @@ bool q_delete_dup(struct list_head *head)
         struct list_head *next = cur->next;
         if (dup) {
             list_del(cur);
-            free(node1->value);
-            free(node1);
+            to_queue(head)->size--;
+            index_del(to_queue(head), node1);
+            q_release_element(node1);
         }
         cur = next;
     }
     return true;
 }
 
+struct dup_slot {
+    element_t *first; /* first element holding the string, NULL if unused */
+    uint32_t tag;     /* upper half of the hash of the string */
+    bool dup;         /* whether later elements held the string too */
+};
+
+/* Delete all nodes whose string occurs more than once anywhere in the queue
+ *
+ * A single pass looks every element up in an open-addressing table with
+ * linear probing, sized to stay at most half full. The first element holding
+ * a string is recorded in its slot, later ones are deleted on the spot and
+ * mark the slot. A final sweep over the table deletes the recorded elements
+ * of the marked slots.
+ */
+bool q_delete_dup_all(struct list_head *head)
+{
+    if (!head || list_empty(head))
+        return false;
+
+    size_t cap = 16;
+    while (cap < 2 * (size_t) q_size(head))
+        cap <<= 1;
+
+    struct dup_slot *table = calloc(cap, sizeof(*table));
+    if (!table)
+        return false;
+
+    to_queue(head)->mid = NULL;
+
+    struct list_head *cur, *safe;
+    list_for_each_safe (cur, safe, head) {
+        element_t *e = list_entry(cur, element_t, list);
+        uint64_t h = value_hash(e);
+        uint32_t tag = h >> 32;
+        size_t i = h & (cap - 1);
+
+        while (table[i].first &&
+               (table[i].tag != tag || value_cmp(table[i].first, e)))
+            i = (i + 1) & (cap - 1);
+
+        if (!table[i].first) {
+            table[i].first = e;
+            table[i].tag = tag;
+            continue;
+        }
+
+        table[i].dup = true;
+        list_del(cur);
+        to_queue(head)->size--;
+        index_del(to_queue(head), e);
+        q_release_element(e);
+    }
+
+    for (size_t i = 0; i < cap; i++) {
+        if (table[i].dup) {
+            list_del(&table[i].first->list);
+            to_queue(head)->size--;
+            index_del(to_queue(head), table[i].first);
+            q_release_element(table[i].first);
+        }
+    }
+
+    free(table);
+    return true;
+}
+
 /* Swap every two adjacent nodes */
 void q_swap(struct list_head *head)
 {
@@ -213,6 +1061,8 @@ void q_swap(struct list_head *head)
     if (count == 0 || count == 1)
         return;
 
+    queue_t *queue = to_queue(head);
+
     while (count > 1) {
         struct list_head *temp = head;
 
@@ -232,13 +1082,17 @@ void q_swap(struct list_head *head)
         count -= 2;
         head = head->next->next;
     }
+
+    /* The middle node traded places with its partner */
+    if (queue->mid)
+        queue->mid =
+            (queue->size / 2) & 1 ? queue->mid->next : queue->mid->prev;
 }
 
 /* Reverse elements in queue */
 void q_reverse(struct list_head *head)
 {
-    int count = q_size(head);
-    if (count == 0 || count == 1)
+    if (!head || list_empty(head) || list_is_singular(head))
         return;
 
     struct list_head *cur = head;
@@ -250,171 +1104,725 @@ void q_reverse(struct list_head *head)
         temp = temp->next;
         cur = cur->prev;
     } while (cur != head);
+
+    /* For an even size the old middle node lands one before the middle */
+    queue_t *queue = to_queue(head);
+    if (queue->mid && !(queue->size & 1))
+        queue->mid = queue->mid->next;
 }
 
 /* Reverse the nodes of the list k at a time */
 void q_reverseK(struct list_head *head, int k)
 {
-    if (list_empty(head) || q_size(head) == 1 || k == 1)
+    if (!head || k < 2)
         return;
 
-    int count = 0;
+    /* The size tells up front how many full groups there are, so every node
+     * is relinked once as it is walked, without a look-ahead per group.
+     */
+    queue_t *queue = to_queue(head);
+    size_t groups = queue->size / k;
+
+    /* The node landing in the middle, if the middle is in a full group */
+    size_t m = queue->size / 2, mid_from = SIZE_MAX;
+    if (m / k < groups)
+        mid_from = m - m % k + (k - 1 - m % k);
+
+    struct list_head *before = head, *node = head->next;
+    size_t i = 0;
+    while (groups--) {
+        struct list_head *first = node, *last = before;
+        for (int j = 0; j < k; j++, i++) {
+            struct list_head *next = node->next;
+            node->next = last;
+            node->prev = next;
+            if (i == mid_from)
+                queue->mid = node;
+            last = node;
+            node = next;
+        }
+
+        /* @last is the old tail of the group, @node the node after it */
+        before->next = last;
+        last->prev = before;
+        first->next = node;
+        node->prev = first;
+        before = first;
+    }
+}
+
+/* Compare two elements in the requested order; <= 0 keeps @a in front */
+static inline int element_cmp(const struct list_head *a,
+                              const struct list_head *b,
+                              bool descend)
+{
+    int r = value_cmp(list_entry(a, element_t, list),
+                      list_entry(b, element_t, list));
+    return descend ? -r : r;
+}
+
+/* Once one run has supplied this many elements in a row, merge_runs() stops
+ * comparing element by element and gallops through that run instead.
+ */
+#define MIN_GALLOP 7
 
-    struct list_head *node, *safe;
-    struct list_head *temp = head;
+/* Upper bound on pending runs. The stack invariants of timsort() make run
+ * lengths grow at least like Fibonacci numbers from the top of the stack
+ * down, so far fewer than this many runs can be pending for any queue that
+ * fits in memory.
+ */
+#define MAX_PENDING 128
+
+struct run {
+    struct list_head *list; /* NULL-terminated, linked through @next */
+    size_t len;
+};
+
+/* Return the last node of the longest prefix of @list whose elements sort
+ * before @key, counting ties as before only if @ties is set. The first node
+ * of @list must already be known to qualify.
+ *
+ * The prefix end is bracketed by probing nodes 1, 3, 7, 15, ... steps ahead,
+ * and then located by binary search inside the bracket. On a linked list this
+ * still walks every node, but it only compares O(log n) of them.
+ */
+static struct list_head *gallop(struct list_head *list,
+                                const struct list_head *key,
+                                bool ties,
+                                bool descend)
+{
+    struct list_head *good = list;
+    size_t step = 1;
 
-    list_for_each_safe (node, safe, head) {
-        count++;
-        if (count == k) {
-            struct list_head head_to;
-            INIT_LIST_HEAD(&head_to);
+    for (;;) {
+        struct list_head *probe = good;
+        size_t dist = 0;
 
-            list_cut_position(&head_to, temp, node);
-            q_reverse(&head_to);
-            list_splice_init(&head_to, temp);
+        while (dist < step && probe->next) {
+            probe = probe->next;
+            dist++;
+        }
+        if (!dist)
+            return good;
 
-            temp = safe->prev;
-            count = 0;
+        int r = element_cmp(probe, key, descend);
+        if (r < 0 || (ties && !r)) {
+            good = probe;
+            step <<= 1;
+            continue;
         }
+
+        /* @good qualifies and the node @dist steps after it does not */
+        size_t lo = 0, hi = dist;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            struct list_head *node = good;
+            for (size_t k = lo; k < mid; k++)
+                node = node->next;
+
+            r = element_cmp(node, key, descend);
+            if (r < 0 || (ties && !r)) {
+                good = node;
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return good;
     }
 }
-/* Sort elements of queue in ascending/descending order */
-void q_sort(struct list_head *head, bool descend)
+
+/* Merge two adjacent sorted runs. @a holds the elements that came first in
+ * the queue, so ties are taken from it, which keeps the sort stable.
+ */
+static struct list_head *merge_runs(struct list_head *a,
+                                    struct list_head *b,
+                                    bool descend)
 {
-    if (!head || list_empty(head) || list_is_singular(head))
-        return;
+    struct list_head *head = NULL, **tail = &head;
+    unsigned int wins_a = 0, wins_b = 0;
+
+    while (a && b) {
+        struct list_head *last;
+
+        if (element_cmp(a, b, descend) <= 0) {
+            wins_b = 0;
+            last = ++wins_a < MIN_GALLOP ? a : gallop(a, b, true, descend);
+            *tail = a;
+            tail = &last->next;
+            a = last->next;
+        } else {
+            wins_a = 0;
+            last = ++wins_b < MIN_GALLOP ? b : gallop(b, a, false, descend);
+            *tail = b;
+            tail = &last->next;
+            b = last->next;
+        }
+    }
+    *tail = a ? a : b;
 
-    struct list_head *fast = head->next;
-    struct list_head *slow = head;
+    return head;
+}
 
-    while (fast != head && fast->next != head) {
-        slow = slow->next;
-        fast = fast->next->next;
-    }
+/* Detach the natural run at the front of @list and return it. The remainder
+ * of the list is stored in @rest.
+ *
+ * A run starting with a strict descent continues for as long as elements do
+ * not ascend, and is reversed on the fly by prepending each element to the
+ * run. Equal elements are appended to the group of equal elements at the
+ * front instead, so reversing never changes their relative order.
+ */
+static struct run find_run(struct list_head *list,
+                           struct list_head **rest,
+                           bool descend)
+{
+    struct run run = {.list = list, .len = 1};
+    struct list_head *next = list->next;
+
+    if (next && element_cmp(list, next, descend) > 0) {
+        struct list_head *group = list;
 
-    struct list_head half;
-    INIT_LIST_HEAD(&half);
-    list_cut_position(&half, head, slow);
+        list->next = NULL;
+        for (; next; run.len++) {
+            int r = element_cmp(run.list, next, descend);
+            if (r < 0)
+                break;
 
-    q_sort(&half, descend);
-    q_sort(head, descend);
-    merge_two_list(head, &half);
+            struct list_head *node = next;
+            next = node->next;
+            if (r) {
+                node->next = run.list;
+                run.list = group = node;
+            } else {
+                node->next = group->next;
+                group->next = node;
+                group = node;
+            }
+        }
+    } else {
+        while (next && element_cmp(list, next, descend) <= 0) {
+            run.len++;
+            list = next;
+            next = list->next;
+        }
+        list->next = NULL;
+    }
+
+    *rest = next;
+    return run;
 }
 
-/* Remove every node which has a node with a strictly less value anywhere to
- * the right side of it */
-int q_ascend(struct list_head *head)
+/* Merge the last two runs back into the queue at @head, rebuilding the @prev
+ * links and the circular structure on the way.
+ */
+static void merge_final(struct list_head *head,
+                        struct list_head *a,
+                        struct list_head *b,
+                        bool descend)
 {
-    int count = q_size(head);
-    if (count == 0 || count == 1)
-        return count;
+    struct list_head *tail = head;
+
+    while (a && b) {
+        struct list_head **src = element_cmp(a, b, descend) <= 0 ? &a : &b;
+        tail->next = *src;
+        (*src)->prev = tail;
+        tail = *src;
+        *src = (*src)->next;
+    }
 
-    q_reverse(head);
+    for (a = a ? a : b; a; a = a->next) {
+        tail->next = a;
+        a->prev = tail;
+        tail = a;
+    }
+    tail->next = head;
+    head->prev = tail;
+}
 
-    struct list_head *cur = head->next;
-    struct list_head *temp = head->next->next;
+/* Merge run @n of @stack with run @n + 1 and close the gap on the stack */
+static void merge_at(struct run *stack, size_t *top, size_t n, bool descend)
+{
+    stack[n].list = merge_runs(stack[n].list, stack[n + 1].list, descend);
+    stack[n].len += stack[n + 1].len;
+    for (size_t i = n + 1; i + 1 < *top; i++)
+        stack[i] = stack[i + 1];
+    (*top)--;
+}
 
-    while (temp != head) {
-        const element_t *node1 = container_of(cur, element_t, list);
-        element_t *node2 = container_of(temp, element_t, list);
+/* Adaptive, stable merge sort in the style of Timsort
+ *
+ * The NULL-terminated @list is cut into natural runs: maximal non-descending
+ * stretches, and non-ascending ones which are reversed in place. Runs are
+ * pushed onto a stack that is kept balanced by the Timsort invariants
+ *
+ *   len[i - 2] > len[i - 1] + len[i]  and  len[i - 1] > len[i]
+ *
+ * merging neighbours whenever they are violated, so every merge joins runs
+ * of comparable length. Merges gallop through long stretches taken from the
+ * same run. A list that is already sorted, in either direction, consists of
+ * a single run and is handled in linear time.
+ *
+ * The @prev links are ignored while sorting. If @head is given, the final
+ * merge links the result back into it as a circular list and NULL is
+ * returned; otherwise the sorted NULL-terminated list is returned.
+ */
+static struct list_head *timsort(struct list_head *list,
+                                 struct list_head *head,
+                                 bool descend)
+{
+    struct run stack[MAX_PENDING];
+    size_t top = 0;
 
-        if (strcmp(node1->value, node2->value) < 0) {
-            list_del(&node2->list);
-            free(node2->value);
-            free(node2);
-            temp = cur->next;
-        } else {
-            cur = cur->next;
-            temp = temp->next;
+    do {
+        stack[top++] = find_run(list, &list, descend);
+
+        while (top > 1) {
+            size_t n = top - 2;
+            if ((n > 0 &&
+                 stack[n - 1].len <= stack[n].len + stack[n + 1].len) ||
+                (n > 1 &&
+                 stack[n - 2].len <= stack[n - 1].len + stack[n].len)) {
+                if (stack[n - 1].len < stack[n + 1].len)
+                    n--;
+            } else if (stack[n].len > stack[n + 1].len) {
+                break;
+            }
+            merge_at(stack, &top, n, descend);
         }
+    } while (list);
+
+    while (top > 2) {
+        size_t n = top - 2;
+        if (stack[n - 1].len < stack[n + 1].len)
+            n--;
+        merge_at(stack, &top, n, descend);
     }
 
-    q_reverse(head);
+    if (head) {
+        merge_final(head, stack[0].list, top > 1 ? stack[1].list : NULL,
+                    descend);
+        return NULL;
+    }
 
-    return q_size(head);
+    if (top > 1)
+        merge_at(stack, &top, 0, descend);
+    return stack[0].list;
 }
 
-/* Remove every node which has a node with a strictly greater value anywhere
- * to the right side of it */
-int q_descend(struct list_head *head)
+/* Buckets with fewer elements than this are handed to timsort() */
+#define RADIX_CUTOFF 32
+
+/* MSD radix sort on the key prefix of the elements
+ *
+ * The NULL-terminated @list of @len elements is distributed over 256
+ * buckets by byte @depth of the key, and the buckets are concatenated in
+ * ascending, or for @descend descending, byte order. Each bucket is sorted
+ * recursively on the next byte, except when its strings are known to be
+ * equal: in bucket 0 they all ended before @depth, and so did those of a
+ * bucket whose keys are identical and end in a NUL byte. A bucket of
+ * identical keys without a NUL skips the remaining passes.
+ * Appending to the bucket tails keeps every pass stable. Small buckets, and
+ * buckets that still tie after all 8 key bytes, are finished by timsort(),
+ * which compares the rest of the strings.
+ *
+ * Return the sorted NULL-terminated list and store its last node in @last.
+ */
+static struct list_head *radix_sort(struct list_head *list,
+                                    size_t len,
+                                    int depth,
+                                    bool descend,
+                                    struct list_head **last)
 {
-    int count = q_size(head);
-    if (count == 0 || count == 1)
-        return count;
+    if (len < RADIX_CUTOFF || depth == 8) {
+        list = timsort(list, NULL, descend);
+        for (*last = list; (*last)->next; *last = (*last)->next)
+            ;
+        return list;
+    }
 
-    q_reverse(head);
+    struct {
+        struct list_head *head, **tail;
+        size_t len;
+        uint64_t key;
+        bool mixed;
+    } bucket[256];
+    int shift = 56 - 8 * depth;
+
+    for (int i = 0; i < 256; i++) {
+        bucket[i].tail = &bucket[i].head;
+        bucket[i].len = 0;
+        bucket[i].mixed = false;
+    }
 
-    struct list_head *cur = head->next;
-    struct list_head *temp = head->next->next;
+    while (list) {
+        uint64_t key = list_entry(list, element_t, list)->key;
+        int b = (key >> shift) & 0xff;
+        if (!bucket[b].len)
+            bucket[b].key = key;
+        else if (key != bucket[b].key)
+            bucket[b].mixed = true;
+        *bucket[b].tail = list;
+        bucket[b].tail = &list->next;
+        bucket[b].len++;
+        list = list->next;
+    }
 
-    while (temp != head) {
-        const element_t *node1 = container_of(cur, element_t, list);
-        element_t *node2 = container_of(temp, element_t, list);
+    struct list_head *sorted = NULL, **tail = &sorted;
+    for (int i = 0; i < 256; i++) {
+        int b = descend ? 255 - i : i;
+        if (!bucket[b].len)
+            continue;
 
-        if (strcmp(node1->value, node2->value) > 0) {
-            list_del(&node2->list);
-            free(node2->value);
-            free(node2);
-            temp = cur->next;
+        *bucket[b].tail = NULL;
+        if (b && bucket[b].len > 1 &&
+            (bucket[b].mixed || (bucket[b].key & 0xff))) {
+            /* Further passes cannot split a bucket of equal keys */
+            *tail = radix_sort(bucket[b].head, bucket[b].len,
+                               bucket[b].mixed ? depth + 1 : 8, descend,
+                               last);
         } else {
-            cur = cur->next;
-            temp = temp->next;
+            *tail = bucket[b].head;
+            *last = container_of(bucket[b].tail, struct list_head, next);
         }
+        tail = &(*last)->next;
     }
 
-    q_reverse(head);
+    return sorted;
+}
 
-    return q_size(head);
+static int sort_algo = Q_SORT_MERGE;
+
+/* Select the engine used by q_sort() */
+bool q_sort_set_algo(int algo)
+{
+    if (algo != Q_SORT_MERGE && algo != Q_SORT_RADIX)
+        return false;
+
+    sort_algo = algo;
+    return true;
 }
 
-/* Merge all the queues into one sorted queue, which is in
- * ascending/descending order */
-int q_merge(struct list_head *head, bool descend)
+/* Sort the circular list @head of @len elements with the selected engine */
+static void sort_list(struct list_head *head, size_t len, bool descend)
 {
-    if (!head || list_empty(head))
-        return 0;
+    if (len < 2)
+        return;
 
-    queue_contex_t *q_head = container_of(head->next, queue_contex_t, chain);
+    /* Convert to a NULL-terminated singly-linked list */
+    head->prev->next = NULL;
 
-    if (q_head->chain.next == q_head->chain.prev)
-        return q_head->size;
+    if (sort_algo != Q_SORT_RADIX) {
+        timsort(head->next, head, descend);
+        return;
+    }
 
-    struct list_head *cur;
-    struct list_head *safe;
-    queue_contex_t *cur_queue;
+    struct list_head *last;
+    struct list_head *list = radix_sort(head->next, len, 0, descend, &last);
 
-    list_for_each_safe (cur, safe, head) {
-        if (cur == &q_head->chain) {
-            continue;
+    /* Restore the @prev links and the circular structure */
+    struct list_head *prev = head;
+    for (; list; list = list->next) {
+        list->prev = prev;
+        prev->next = list;
+        prev = list;
+    }
+    prev->next = head;
+    head->prev = prev;
+}
+
+/* Number of queues merged by one heap. q_merge() must not allocate, so the
+ * heap lives on the stack and longer chains are merged in several passes.
+ */
+#define MERGE_FANIN 256
+
+struct merge_src {
+    struct list_head *node; /* next element to take */
+    struct list_head *end;  /* head of the queue it comes from */
+    int idx;                /* position in the chain, breaks ties */
+};
+
+static inline bool src_before(const struct merge_src *a,
+                              const struct merge_src *b,
+                              bool descend)
+{
+    int r = element_cmp(a->node, b->node, descend);
+    return r < 0 || (!r && a->idx < b->idx);
+}
+
+static void sift_down(struct merge_src *heap, int n, int i, bool descend)
+{
+    struct merge_src src = heap[i];
+
+    for (int c; (c = 2 * i + 1) < n; i = c) {
+        if (c + 1 < n && src_before(&heap[c + 1], &heap[c], descend))
+            c++;
+        if (!src_before(&heap[c], &src, descend))
+            break;
+        heap[i] = heap[c];
+    }
+    heap[i] = src;
+}
+
+/* Merge the sorted queues in @heap into @dst in a single pass, leaving the
+ * other queues empty. @dst may itself be one of the sources: its elements
+ * are only relinked after they have been taken from the heap.
+ */
+static void merge_heap(struct list_head *dst,
+                       struct merge_src *heap,
+                       int n,
+                       bool descend)
+{
+    struct list_head *tail = dst;
+
+    for (int i = n / 2 - 1; i >= 0; i--)
+        sift_down(heap, n, i, descend);
+
+    while (n > 1) {
+        struct list_head *node = heap[0].node;
+        tail->next = node;
+        node->prev = tail;
+        tail = node;
+
+        if (node->next == heap[0].end) {
+            if (heap[0].end != dst)
+                INIT_LIST_HEAD(heap[0].end);
+            heap[0] = heap[--n];
+        } else {
+            heap[0].node = node->next;
         }
-        cur_queue = container_of(cur, queue_contex_t, chain);
-        list_splice_tail_init(cur_queue->q, q_head->q);
-        q_head->size += cur_queue->size;
+        sift_down(heap, n, 0, descend);
+    }
+
+    /* The last queue standing is appended as a whole */
+    if (n) {
+        tail->next = heap[0].node;
+        heap[0].node->prev = tail;
+        tail = heap[0].end->prev;
+        if (heap[0].end != dst)
+            INIT_LIST_HEAD(heap[0].end);
     }
+    tail->next = dst;
+    dst->prev = tail;
+}
+
+/* Queues shorter than this are sorted by a single thread even when more are
+ * allowed, as starting the threads would cost more than it saves.
+ */
+#define PARALLEL_SORT_MIN (1 << 17)
+#define MAX_SORT_THREADS 64
+
+static int sort_threads = 1;
+
+/* Set the number of threads q_sort() may use on large queues */
+bool q_sort_set_threads(int threads)
+{
+    if (threads < 0 || threads > MAX_SORT_THREADS)
+        return false;
 
-    q_sort(q_head->q, descend);
-    return q_head->size;
+    if (!threads) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus < 1                  ? 1
+                  : cpus > MAX_SORT_THREADS ? MAX_SORT_THREADS
+                                            : (int) cpus;
+    }
+    sort_threads = threads;
+    return true;
 }
 
-void merge_two_list(struct list_head *L1, struct list_head *L2)
+struct sort_job {
+    pthread_t thread;
+    struct list_head head; /* segment of the queue sorted by this job */
+    size_t len;
+    bool descend;
+    bool started;
+};
+
+static void *sort_worker(void *arg)
 {
-    struct list_head temp;
-    INIT_LIST_HEAD(&temp);
+    struct sort_job *job = arg;
+    sort_list(&job->head, job->len, job->descend);
+    return NULL;
+}
 
-    while (!list_empty(L1) && !list_empty(L2)) {
-        element_t *node1 = container_of(L1->next, element_t, list);
-        element_t *node2 = container_of(L2->next, element_t, list);
-        if (strcmp(node1->value, node2->value) < 0) {
-            list_move_tail(&node1->list, &temp);
+/* Sort @head on @threads threads
+ *
+ * The queue is cut into one segment per thread with list_cut_position(), the
+ * segments are sorted concurrently, and merge_heap() merges them back into
+ * @head in a single pass. The calling thread sorts the last segment itself.
+ * If a thread cannot be started, its segment is sorted by the caller too.
+ *
+ * Nothing here allocates through the harness, so the noallocate mode of
+ * qtest holds. The threads must not take signals though: the handlers of
+ * qtest longjmp to the exception context of the main thread. SIGALRM is
+ * blocked before the threads are created, so they inherit the mask, and
+ * stays blocked in the caller until all of them are joined. A timeout is
+ * then delivered on return, once @head is a consistent list again.
+ */
+static void parallel_sort(struct list_head *head,
+                          size_t len,
+                          int threads,
+                          bool descend)
+{
+    struct sort_job job[MAX_SORT_THREADS];
+    struct merge_src heap[MAX_SORT_THREADS];
+    sigset_t block, saved;
+
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &saved);
+
+    for (int i = 0; i < threads; i++) {
+        struct sort_job *j = &job[i];
+
+        INIT_LIST_HEAD(&j->head);
+        j->descend = descend;
+        j->started = false;
+
+        if (i < threads - 1) {
+            struct list_head *cut = head;
+            j->len = len / threads;
+            for (size_t n = 0; n < j->len; n++)
+                cut = cut->next;
+            list_cut_position(&j->head, head, cut);
+            j->started = !pthread_create(&j->thread, NULL, sort_worker, j);
         } else {
-            list_move_tail(&node2->list, &temp);
+            j->len = len - (len / threads) * (threads - 1);
+            list_splice_init(head, &j->head);
         }
+
+        if (!j->started)
+            sort_list(&j->head, j->len, descend);
     }
 
-    if (!list_empty(L1))
-        list_splice_tail_init(L1, &temp);
+    for (int i = 0; i < threads; i++) {
+        if (job[i].started)
+            pthread_join(job[i].thread, NULL);
+        heap[i] = (struct merge_src){job[i].head.next, &job[i].head, i};
+    }
+    merge_heap(head, heap, threads, descend);
+
+    pthread_sigmask(SIG_SETMASK, &saved, NULL);
+}
+
+/* Sort elements of queue in ascending/descending order */
+void q_sort(struct list_head *head, bool descend)
+{
+    if (!head || list_empty(head) || list_is_singular(head))
+        return;
+
+    size_t len = q_size(head);
+    to_queue(head)->mid = NULL;
+
+    if (sort_threads > 1 && len >= PARALLEL_SORT_MIN)
+        parallel_sort(head, len, sort_threads, descend);
     else
-        list_splice_tail_init(L2, &temp);
+        sort_list(head, len, descend);
+}
+
+/* Delete every node that sorts after some node to its right, in a single
+ * backward pass
+ *
+ * Walking from the tail, the last node kept so far is the smallest one seen
+ * (the largest for @descend), so each node is compared with it only once.
+ */
+static int keep_monotonic(struct list_head *head, bool descend)
+{
+    if (!head || list_empty(head))
+        return 0;
+
+    to_queue(head)->mid = NULL;
+    struct list_head *last = head->prev;
+    for (struct list_head *cur = last->prev, *prev; cur != head; cur = prev) {
+        prev = cur->prev;
+        if (element_cmp(cur, last, descend) > 0) {
+            list_del(cur);
+            to_queue(head)->size--;
+            index_del(to_queue(head), list_entry(cur, element_t, list));
+            q_release_element(list_entry(cur, element_t, list));
+        } else {
+            last = cur;
+        }
+    }
+
+    return q_size(head);
+}
+
+/* Remove every node which has a node with a strictly less value anywhere to
+ * the right side of it */
+int q_ascend(struct list_head *head)
+{
+    return keep_monotonic(head, false);
+}
+
+/* Remove every node which has a node with a strictly greater value anywhere
+ * to the right side of it */
+int q_descend(struct list_head *head)
+{
+    return keep_monotonic(head, true);
+}
+
+/* Merge all the queues into one sorted queue, which is in ascending/descending
+ * order
+ *
+ * The sorted queues are merged with a binary heap holding the front element
+ * of each queue, so every element is moved once per pass at O(log k)
+ * comparisons. Equal elements keep the order of their queues in the chain.
+ */
+int q_merge(struct list_head *head, bool descend)
+{
+    if (!head || list_empty(head))
+        return 0;
+
+    queue_contex_t *first = list_first_entry(head, queue_contex_t, chain);
+
+    if (list_is_singular(head))
+        return first->size;
+
+    struct merge_src heap[MERGE_FANIN];
+    int groups;
+
+    do {
+        queue_contex_t *ctx, *leader = NULL;
+        int members = 0, n = 0;
+
+        groups = 0;
+        list_for_each_entry (ctx, head, chain) {
+            if (ctx != first && list_empty(ctx->q))
+                continue;
+
+            if (members == MERGE_FANIN) {
+                merge_heap(leader->q, heap, n, descend);
+                members = n = 0;
+            }
+
+            if (!members++) {
+                leader = ctx;
+                groups++;
+            } else {
+                queue_t *dst = to_queue(leader->q);
+                /* Moving the index counts could allocate, leave them to the
+                 * next q_find() instead
+                 */
+                if (dst->index)
+                    dst->index->stale = true;
+                if (to_queue(ctx->q)->index)
+                    to_queue(ctx->q)->index->stale = true;
+                dst->size += q_size(ctx->q);
+                dst->mixed = true;
+                dst->mid = NULL;
+                to_queue(ctx->q)->size = 0;
+                to_queue(ctx->q)->mid = ctx->q;
+                leader->size += ctx->size;
+                ctx->size = 0;
+            }
+
+            if (!list_empty(ctx->q)) {
+                heap[n] = (struct merge_src){ctx->q->next, ctx->q, n};
+                n++;
+            }
+        }
+        merge_heap(leader->q, heap, n, descend);
+    } while (groups > 1);
 
-    list_splice(&temp, L1);
+    return q_size(first->q);
 }
@@ -9,22 +9,67 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "harness.h"
 #include "list.h"
 
+struct q_pool;
+struct q_index;
+
 /**
  * element_t - Linked list element
  * @value: pointer to array holding string
  * @list: node of a doubly-linked list
+ * @pool: node pool the element was carved from, NULL for a heap element
+ * @key: first 8 bytes of @value, zero padded, packed in big-endian order
+ * @inline_value: storage for short strings, allocated together with the
+ *                element
+ *
+ * @value either points to @inline_value, to a separately allocated string, or
+ * to an interned string shared with other elements. Use q_release_element()
+ * to free an element in all cases.
  *
- * @value needs to be explicitly allocated and freed
+ * Comparing @key as an integer orders two elements the same way strcmp()
+ * orders their first 8 bytes, so most comparisons never touch @value.
  */
 typedef struct {
     char *value;
     struct list_head list;
+    struct q_pool *pool;
+    uint64_t key;
+    char inline_value[];
 } element_t;
 
+/**
+ * queue_t - Queue header returned by q_new()
+ * @head: head of the circular doubly-linked list of elements
+ * @size: the number of elements linked into @head
+ * @pool: node pool new elements are allocated from, NULL to use the heap
+ * @mixed: whether @head may hold elements that did not come from @pool
+ * @mid: the node at index @size / 2, @head if the queue is empty, or NULL if
+ *       unknown
+ * @index: hash index of the strings in @head, NULL unless q_index_enable()
+ *         was called
+ * @intern: whether new elements share interned strings, see q_intern_enable()
+ *
+ * @head must stay the first member: callers only ever see &queue->head, and
+ * container_of() maps it back to the queue_t. @size is kept up to date by
+ * every operation that links or unlinks elements, so q_size() runs in
+ * constant time. Insertion and removal at either end, q_delete_mid(),
+ * q_swap() and q_reverse() move @mid by at most one step, the other
+ * operations reset it to NULL and the next q_delete_mid() finds it again.
+ */
+typedef struct {
+    struct list_head head;
+    int size;
+    struct q_pool *pool;
+    bool mixed;
+    struct list_head *mid;
+    struct q_index *index;
+    bool intern;
+} queue_t;
+
 /**
  * queue_contex_t - The context managing a chain of queues
  * @q: pointer to the head of the queue
@@ -54,6 +99,77 @@ struct list_head *q_new();
  */
 void q_free(struct list_head *head);
 
+/**
+ * q_pool_enable() - Allocate the elements of a queue from a node pool
+ * @head: header of an empty queue
+ *
+ * Elements inserted afterwards, together with their inline strings, are carved
+ * out of slabs owned by the queue instead of being allocated one by one. The
+ * slabs are obtained with malloc, so they remain visible to the allocation
+ * checks of the test harness, and q_free() releases them in bulk.
+ *
+ * Return: true for success, false if queue is NULL, not empty, or allocation
+ * failed
+ */
+bool q_pool_enable(struct list_head *head);
+
+/**
+ * q_intern_enable() - Share the strings of equal elements of a queue
+ * @head: header of an empty queue
+ *
+ * Elements inserted afterwards no longer own a copy of their string. They
+ * refer to a single copy per distinct string, kept with a reference count in
+ * an intern table shared by all interning queues, and q_release_element()
+ * drops the reference instead of freeing the string. The nodes come from a
+ * node pool, as after q_pool_enable(), unless it cannot be allocated. A queue
+ * of a million equal strings thus holds one copy of it in a few hundred
+ * blocks.
+ *
+ * Return: true for success, false if queue is NULL or not empty
+ */
+bool q_intern_enable(struct list_head *head);
+
+/**
+ * q_interns() - Tell whether a queue shares the strings of equal elements
+ * @head: header of queue
+ *
+ * Return: true if q_intern_enable() succeeded on queue, false otherwise or if
+ * queue is NULL
+ */
+bool q_interns(struct list_head *head);
+
+/**
+ * q_index_enable() - Keep a hash index of the strings in queue
+ * @head: header of queue
+ *
+ * The index is built from the elements already in the queue, then every
+ * operation that links or unlinks elements keeps it up to date, so that
+ * q_find() takes constant expected time. Its memory is allocated with
+ * malloc_or_fail(), so it shows in the allocation counters of report.c rather
+ * than among the blocks the test harness checks for leaks, and q_free()
+ * releases it. No effect if the queue already has an index.
+ *
+ * q_merge() must not allocate, so it only marks the indexes of the merged
+ * queues as stale, and the next q_find() on each of them rebuilds its index
+ * in linear time.
+ *
+ * Return: true for success, false if queue is NULL
+ */
+bool q_index_enable(struct list_head *head);
+
+/**
+ * q_find() - Count the elements holding a string
+ * @head: header of queue
+ * @s: string to look for
+ *
+ * Looks @s up in the hash index of the queue if it has one, and compares it
+ * with every element otherwise.
+ *
+ * Return: the number of elements whose value equals @s, zero if there is none
+ * or queue is NULL
+ */
+int q_find(struct list_head *head, const char *s);
+
 /**
  * q_insert_head() - Insert an element in the head
  * @head: header of queue
@@ -78,6 +194,45 @@ bool q_insert_head(struct list_head *head, char *s);
  */
 bool q_insert_tail(struct list_head *head, char *s);
 
+/**
+ * q_insert_head_bulk() - Insert several elements in the head
+ * @head: header of queue
+ * @s: first string would be inserted
+ * @stride: distance in bytes from each string to the next one, 0 to insert
+ *          @s @n times
+ * @n: number of strings
+ *
+ * The result is the same as calling q_insert_head() on each string in turn,
+ * so the last string ends up in front. Unless the queue has a node pool, the
+ * elements and their strings are allocated as one contiguous block, which is
+ * freed once all of its elements have been released. The new elements are
+ * linked into the queue with a single splice, and nothing is inserted if
+ * allocation fails.
+ *
+ * Return: true for success, false for allocation failed or queue is NULL
+ */
+bool q_insert_head_bulk(struct list_head *head,
+                        const char *s,
+                        size_t stride,
+                        size_t n);
+
+/**
+ * q_insert_tail_bulk() - Insert several elements at the tail
+ * @head: header of queue
+ * @s: first string would be inserted
+ * @stride: distance in bytes from each string to the next one, 0 to insert
+ *          @s @n times
+ * @n: number of strings
+ *
+ * The bulk counterpart of q_insert_tail(), see q_insert_head_bulk().
+ *
+ * Return: true for success, false for allocation failed or queue is NULL
+ */
+bool q_insert_tail_bulk(struct list_head *head,
+                        const char *s,
+                        size_t stride,
+                        size_t n);
+
 /**
  * q_remove_head() - Remove the element from head of queue
  * @head: header of queue
@@ -108,22 +263,50 @@ element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize);
  */
 element_t *q_remove_tail(struct list_head *head, char *sp, size_t bufsize);
 
+/**
+ * q_remove_head_n() - Remove up to n elements from head of queue
+ * @head: header of queue
+ * @list: list head receiving the removed elements, overwritten
+ * @n: maximum number of elements to remove
+ * @sp: arena receiving the removed strings, NULL to skip copying
+ * @bufsize: size of the arena
+ *
+ * The removed elements are detached with a single list_cut_position() and
+ * handed back through @list in queue order. Like q_remove_head(), they are
+ * not freed: release each one with q_release_element() once done with it.
+ *
+ * If @sp is non-NULL, the removed strings are also copied into it in order,
+ * each with its null terminator, until the arena is full. The string that
+ * does not fit is truncated to the remaining space, and later ones are not
+ * copied.
+ *
+ * Return: the number of elements removed, 0 if queue is NULL or empty
+ */
+int q_remove_head_n(struct list_head *head,
+                    struct list_head *list,
+                    int n,
+                    char *sp,
+                    size_t bufsize);
+
 /**
  * q_release_element() - Release the element
  * @e: element would be released
  *
+ * Pooled elements are handed back to the pool they came from rather than
+ * freed individually. An interned string loses a reference, and is freed
+ * with the last one.
+ *
  * This function is intended for internal use only.
  */
-static inline void q_release_element(element_t *e)
-{
-    test_free(e->value);
-    test_free(e);
-}
+void q_release_element(element_t *e);
 
 /**
  * q_size() - Get the size of the queue
  * @head: header of queue
  *
+ * The length is read from the queue header rather than counted, so @head must
+ * be a queue created by q_new().
+ *
  * Return: the number of elements in queue, zero if queue is NULL or empty
  */
 int q_size(struct list_head *head);
@@ -136,6 +319,10 @@ int q_size(struct list_head *head);
  * ⌊n / 2⌋th node from the start using 0-based indexing.
  * If there're six elements, the third member should be returned.
  *
+ * The queue tracks its middle node across insertions and removals at either
+ * end, so repeated calls run in constant time. Only the first call after an
+ * operation that reorders the queue walks to the middle.
+ *
  * Reference:
  * https://leetcode.com/problems/delete-the-middle-node-of-a-linked-list/
  *
@@ -155,6 +342,20 @@ bool q_delete_mid(struct list_head *head);
  */
 bool q_delete_dup(struct list_head *head);
 
+/**
+ * q_delete_dup_all() - Delete all nodes whose string occurs more than once
+ *                      anywhere in the queue
+ * @head: header of queue
+ *
+ * Unlike q_delete_dup(), the queue need not be sorted: duplicates are found
+ * with a hash table, so the whole queue is handled in expected linear time.
+ * The remaining nodes keep their relative order.
+ *
+ * Return: true for success, false if list is NULL or empty, or allocation
+ * failed
+ */
+bool q_delete_dup_all(struct list_head *head);
+
 /**
  * q_swap() - Swap every two adjacent nodes
  * @head: header of queue
@@ -185,6 +386,9 @@ void q_reverse(struct list_head *head);
  * No effect if queue is NULL or empty. If there has only one element, do
  * nothing.
  *
+ * The number of full groups follows from the size of the queue, so the nodes
+ * are relinked in place in a single pass, without temporary list heads.
+ *
  * Reference:
  * https://leetcode.com/problems/reverse-nodes-in-k-group/
  */
@@ -196,10 +400,41 @@ void q_reverseK(struct list_head *head, int k);
  * @descend: whether or not to sort in descending order
  *
  * No effect if queue is NULL or empty. If there has only one element, do
- * nothing.
+ * nothing. The sort is stable: elements holding equal strings keep their
+ * relative order.
  */
 void q_sort(struct list_head *head, bool descend);
 
+/* Engines behind q_sort(), see q_sort_set_algo() */
+enum {
+    Q_SORT_MERGE, /* adaptive natural merge sort, the default */
+    Q_SORT_RADIX, /* MSD radix sort on the string bytes */
+};
+
+/**
+ * q_sort_set_algo() - Select the algorithm used by q_sort()
+ * @algo: Q_SORT_MERGE or Q_SORT_RADIX
+ *
+ * Both engines are stable and honor the @descend argument of q_sort(). The
+ * radix sort distributes elements by the leading bytes of their strings,
+ * which beats comparison sorting on very large queues of short strings.
+ *
+ * Return: true for success, false if @algo is unknown
+ */
+bool q_sort_set_algo(int algo);
+
+/**
+ * q_sort_set_threads() - Set the number of threads used by q_sort()
+ * @threads: maximum number of threads, 0 for one per online CPU
+ *
+ * Large queues are cut into one segment per thread, the segments are sorted
+ * concurrently and then merged. Small queues are always sorted by the
+ * calling thread. The default is a single thread.
+ *
+ * Return: true for success, false if @threads is out of range
+ */
+bool q_sort_set_threads(int threads);
+
 /**
  * q_ascend() - Remove every node which has a node with a strictly less
  * value anywhere to the right side of it.
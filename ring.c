@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "harness.h"
+#include "ring.h"
+
+#define RING_MIN_CAPACITY 16
+
+/* Return the slot holding position @i of @r */
+static inline char **ring_slot(const ring_t *r, size_t i)
+{
+    return &r->slot[(r->head + i) & r->mask];
+}
+
+/* Double the capacity of a full ring, unwrapping it at the same time */
+static bool ring_grow(ring_t *r)
+{
+    size_t cap = (r->mask + 1) << 1;
+    char **slot = malloc(cap * sizeof(char *));
+    if (!slot)
+        return false;
+
+    for (size_t i = 0; i < r->size; i++)
+        slot[i] = *ring_slot(r, i);
+
+    free(r->slot);
+    r->slot = slot;
+    r->mask = cap - 1;
+    r->head = 0;
+    return true;
+}
+
+/* Create an empty ring */
+ring_t *ring_new()
+{
+    ring_t *r = malloc(sizeof(ring_t));
+    if (!r)
+        return NULL;
+
+    r->slot = malloc(RING_MIN_CAPACITY * sizeof(char *));
+    if (!r->slot) {
+        free(r);
+        return NULL;
+    }
+    r->mask = RING_MIN_CAPACITY - 1;
+    r->head = 0;
+    r->size = 0;
+    return r;
+}
+
+/* Free all storage used by ring */
+void ring_free(ring_t *r)
+{
+    if (!r)
+        return;
+
+    for (size_t i = 0; i < r->size; i++)
+        free(*ring_slot(r, i));
+    free(r->slot);
+    free(r);
+}
+
+/* Insert a copy of @s at head of ring */
+bool ring_insert_head(ring_t *r, const char *s)
+{
+    if (!r || (r->size > r->mask && !ring_grow(r)))
+        return false;
+
+    char *value = strdup(s);
+    if (!value)
+        return false;
+
+    r->head = (r->head - 1) & r->mask;
+    r->slot[r->head] = value;
+    r->size++;
+    return true;
+}
+
+/* Insert a copy of @s at tail of ring */
+bool ring_insert_tail(ring_t *r, const char *s)
+{
+    if (!r || (r->size > r->mask && !ring_grow(r)))
+        return false;
+
+    char *value = strdup(s);
+    if (!value)
+        return false;
+
+    *ring_slot(r, r->size) = value;
+    r->size++;
+    return true;
+}
+
+/* Copy a removed string to @sp and free it */
+static void ring_take(char *value, char *sp, size_t bufsize)
+{
+    if (sp) {
+        strncpy(sp, value, bufsize - 1);
+        sp[bufsize - 1] = '\0';
+    }
+    free(value);
+}
+
+/* Remove the string from head of ring */
+bool ring_remove_head(ring_t *r, char *sp, size_t bufsize)
+{
+    if (!r || !r->size)
+        return false;
+
+    ring_take(r->slot[r->head], sp, bufsize);
+    r->head = (r->head + 1) & r->mask;
+    r->size--;
+    return true;
+}
+
+/* Remove the string from tail of ring */
+bool ring_remove_tail(ring_t *r, char *sp, size_t bufsize)
+{
+    if (!r || !r->size)
+        return false;
+
+    r->size--;
+    ring_take(*ring_slot(r, r->size), sp, bufsize);
+    return true;
+}
+
+/* Get the string at position @i */
+const char *ring_get(const ring_t *r, size_t i)
+{
+    if (!r || i >= r->size)
+        return NULL;
+    return *ring_slot(r, i);
+}
+
+/* Return number of strings in ring */
+size_t ring_size(const ring_t *r)
+{
+    return r ? r->size : 0;
+}
+
+/* Delete the middle string of ring */
+bool ring_delete_mid(ring_t *r)
+{
+    if (!r || !r->size)
+        return false;
+
+    size_t mid = r->size / 2;
+    free(*ring_slot(r, mid));
+
+    if (mid < r->size - 1 - mid) {
+        /* Fewer strings in front: move them one slot back */
+        for (size_t i = mid; i > 0; i--)
+            *ring_slot(r, i) = *ring_slot(r, i - 1);
+        r->head = (r->head + 1) & r->mask;
+    } else {
+        for (size_t i = mid; i < r->size - 1; i++)
+            *ring_slot(r, i) = *ring_slot(r, i + 1);
+    }
+    r->size--;
+    return true;
+}
+
+/* Swap every two adjacent strings */
+void ring_swap(ring_t *r)
+{
+    if (!r)
+        return;
+
+    for (size_t i = 0; i + 1 < r->size; i += 2) {
+        char *tmp = *ring_slot(r, i);
+        *ring_slot(r, i) = *ring_slot(r, i + 1);
+        *ring_slot(r, i + 1) = tmp;
+    }
+}
+
+/* Reverse the strings at positions @from up to, excluding, @to */
+static void ring_reverse_range(ring_t *r, size_t from, size_t to)
+{
+    while (from + 1 < to) {
+        char *tmp = *ring_slot(r, from);
+        *ring_slot(r, from++) = *ring_slot(r, --to);
+        *ring_slot(r, to) = tmp;
+    }
+}
+
+/* Reverse the strings in ring */
+void ring_reverse(ring_t *r)
+{
+    if (r)
+        ring_reverse_range(r, 0, r->size);
+}
+
+/* Reverse the strings in ring @k at a time */
+void ring_reverseK(ring_t *r, int k)
+{
+    if (!r || k < 2)
+        return;
+
+    for (size_t i = 0; i + k <= r->size; i += k)
+        ring_reverse_range(r, i, i + k);
+}
@@ -0,0 +1,136 @@
+#ifndef LAB0_RING_H
+#define LAB0_RING_H
+
+/* This program implements a double-ended queue of strings on a growable
+ * ring buffer.
+ *
+ * It covers the pure FIFO/LIFO subset of the queue operations, plus array
+ * versions of the ones that reorder elements, for comparison with the linked
+ * list design of queue.c.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * ring_t - Ring buffer of string pointers
+ * @slot: array of @mask + 1 slots, a power of two
+ * @mask: capacity minus one, maps positions to slots
+ * @head: slot of the first string
+ * @size: number of strings stored
+ *
+ * The i-th string of the deque lives in @slot[(@head + i) & @mask]. Each
+ * string is a copy owned by the ring.
+ */
+typedef struct {
+    char **slot;
+    size_t mask;
+    size_t head;
+    size_t size;
+} ring_t;
+
+/**
+ * ring_new() - Create an empty ring
+ *
+ * Return: NULL for allocation failed
+ */
+ring_t *ring_new();
+
+/**
+ * ring_free() - Free all storage used by ring, no effect if ring is NULL
+ * @r: ring
+ */
+void ring_free(ring_t *r);
+
+/**
+ * ring_insert_head() - Insert a copy of a string in the head
+ * @r: ring
+ * @s: string would be inserted
+ *
+ * The slot array doubles when full, so insertion takes amortized constant
+ * time.
+ *
+ * Return: true for success, false for allocation failed or ring is NULL
+ */
+bool ring_insert_head(ring_t *r, const char *s);
+
+/**
+ * ring_insert_tail() - Insert a copy of a string at the tail
+ * @r: ring
+ * @s: string would be inserted
+ *
+ * Return: true for success, false for allocation failed or ring is NULL
+ */
+bool ring_insert_tail(ring_t *r, const char *s);
+
+/**
+ * ring_remove_head() - Remove the string from head of ring
+ * @r: ring
+ * @sp: buffer receiving the removed string, may be NULL
+ * @bufsize: size of @sp
+ *
+ * Copy up to @bufsize - 1 characters of the string to @sp, plus a null
+ * terminator, then free it.
+ *
+ * Return: true for success, false if ring is NULL or empty
+ */
+bool ring_remove_head(ring_t *r, char *sp, size_t bufsize);
+
+/**
+ * ring_remove_tail() - Remove the string from tail of ring
+ * @r: ring
+ * @sp: buffer receiving the removed string, may be NULL
+ * @bufsize: size of @sp
+ *
+ * Return: true for success, false if ring is NULL or empty
+ */
+bool ring_remove_tail(ring_t *r, char *sp, size_t bufsize);
+
+/**
+ * ring_get() - Get the string at a position
+ * @r: ring
+ * @i: position, counted from the head
+ *
+ * Return: the string, NULL if @i is out of range
+ */
+const char *ring_get(const ring_t *r, size_t i);
+
+/**
+ * ring_size() - Get the number of strings in ring
+ * @r: ring
+ *
+ * Return: the number of strings, zero if ring is NULL or empty
+ */
+size_t ring_size(const ring_t *r);
+
+/**
+ * ring_delete_mid() - Delete the middle string
+ * @r: ring
+ *
+ * Deletes the string at position ⌊n / 2⌋, like q_delete_mid(). The shorter
+ * side of the ring is shifted over the hole.
+ *
+ * Return: true for success, false if ring is NULL or empty
+ */
+bool ring_delete_mid(ring_t *r);
+
+/**
+ * ring_swap() - Swap every two adjacent strings
+ * @r: ring
+ */
+void ring_swap(ring_t *r);
+
+/**
+ * ring_reverse() - Reverse the strings in ring
+ * @r: ring
+ */
+void ring_reverse(ring_t *r);
+
+/**
+ * ring_reverseK() - Reverse the strings k at a time
+ * @r: ring
+ * @k: group size, a trailing group shorter than @k is left as it is
+ */
+void ring_reverseK(ring_t *r, int k);
+
+#endif /* LAB0_RING_H */
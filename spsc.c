@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "spsc.h"
+
+/* Create an empty SPSC queue */
+spsc_t *spsc_new(size_t capacity, size_t width)
+{
+    if (!width)
+        return NULL;
+
+    size_t cap = 2;
+    while (cap < capacity)
+        cap <<= 1;
+
+    spsc_t *q = malloc(sizeof(spsc_t));
+    if (!q)
+        return NULL;
+
+    q->slot = malloc(cap * width);
+    if (!q->slot) {
+        free(q);
+        return NULL;
+    }
+
+    q->mask = cap - 1;
+    q->width = width;
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->head, 0);
+    q->head_cache = 0;
+    q->tail_cache = 0;
+    return q;
+}
+
+/* Free all storage used by queue */
+void spsc_free(spsc_t *q)
+{
+    if (!q)
+        return;
+
+    free(q->slot);
+    free(q);
+}
+
+/* Copy @s to tail of queue */
+bool spsc_insert_tail(spsc_t *q, const char *s)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail - q->head_cache > q->mask) {
+        q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail - q->head_cache > q->mask)
+            return false;
+    }
+
+    char *slot = q->slot + (tail & q->mask) * q->width;
+    size_t len = strnlen(s, q->width - 1);
+    memcpy(slot, s, len);
+    slot[len] = '\0';
+
+    /* Publish the slot to the consumer */
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/* Remove the string from head of queue */
+bool spsc_remove_head(spsc_t *q, char *sp, size_t bufsize)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if (head == q->tail_cache) {
+        q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (head == q->tail_cache)
+            return false;
+    }
+
+    if (sp && bufsize) {
+        const char *slot = q->slot + (head & q->mask) * q->width;
+        size_t len = strnlen(slot, bufsize - 1);
+        memcpy(sp, slot, len);
+        sp[len] = '\0';
+    }
+
+    /* Hand the slot back to the producer */
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
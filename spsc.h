@@ -0,0 +1,85 @@
+#ifndef LAB0_SPSC_H
+#define LAB0_SPSC_H
+
+/* This program implements a bounded wait-free queue of strings for exactly
+ * one producer thread and one consumer thread.
+ *
+ * With a single thread at each end, no position is ever contended: the
+ * producer alone advances the tail and the consumer alone advances the head,
+ * so every operation completes in a bounded number of steps, with a load and
+ * a store of the other side's index at most. Each side also keeps a private
+ * copy of the other side's index and only reloads it when the ring looks
+ * full or empty, which keeps the shared cache lines from bouncing between
+ * the two cores on every message.
+ *
+ * The strings are copied into fixed-size slots of the ring, so passing a
+ * message allocates nothing.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "mpmc.h"
+
+/**
+ * spsc_t - Bounded single-producer single-consumer queue of strings
+ * @slot: @mask + 1 slots of @width bytes each
+ * @mask: capacity minus one, a power of two minus one
+ * @width: size of a slot, strings are truncated to @width - 1 characters
+ * @tail: position of the next insertion, written by the producer only
+ * @head_cache: the producer's last view of @head
+ * @head: position of the next removal, written by the consumer only
+ * @tail_cache: the consumer's last view of @tail
+ *
+ * Each index shares its cache line with the private copy of its owner only.
+ */
+typedef struct {
+    char *slot;
+    size_t mask;
+    size_t width;
+    char pad0[MPMC_CACHE_LINE];
+    _Atomic size_t tail;
+    size_t head_cache;
+    char pad1[MPMC_CACHE_LINE - 2 * sizeof(size_t)];
+    _Atomic size_t head;
+    size_t tail_cache;
+    char pad2[MPMC_CACHE_LINE - 2 * sizeof(size_t)];
+} spsc_t;
+
+/**
+ * spsc_new() - Create an empty SPSC queue
+ * @capacity: number of strings it can hold, rounded up to a power of two
+ * @width: size of a slot, including the null terminator
+ *
+ * Return: NULL for allocation failed or @width is zero
+ */
+spsc_t *spsc_new(size_t capacity, size_t width);
+
+/**
+ * spsc_free() - Free all storage used by queue, no effect if it is NULL
+ * @q: SPSC queue, no longer used by any other thread
+ */
+void spsc_free(spsc_t *q);
+
+/**
+ * spsc_insert_tail() - Copy a string to the tail, from the producer thread
+ * @q: SPSC queue
+ * @s: string would be inserted, truncated to the width of a slot
+ *
+ * Return: true for success, false if queue is full
+ */
+bool spsc_insert_tail(spsc_t *q, const char *s);
+
+/**
+ * spsc_remove_head() - Remove the string from the head, from the consumer
+ * thread
+ * @q: SPSC queue
+ * @sp: buffer receiving the removed string, may be NULL
+ * @bufsize: size of @sp
+ *
+ * Return: true for success, false if queue is empty
+ */
+bool spsc_remove_head(spsc_t *q, char *sp, size_t bufsize);
+
+#endif /* LAB0_SPSC_H */
@@ -0,0 +1,23 @@
+# Benchmark of q_ascend and q_descend on queues of one million strings
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-ascend.cmd
+# For the cost of each list traversal, run it under:
+#   perf stat -e cache-misses,cache-references
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 1000000
+time ascend
+free
+new
+ih RAND 1000000
+time descend
+free
+# Sorted queues, where every node survives
+new
+ih RAND 1000000
+sort
+time ascend
+reverse
+time descend
+free
@@ -0,0 +1,13 @@
+# Benchmark of deleting non-adjacent duplicates from one million strings,
+# nine out of ten of which are repeated
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-dedup.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 100000
+it dolphin 300000
+ih gerbil 300000
+it jaguar 300000
+time dedup all
+free
@@ -0,0 +1,124 @@
+# q_delete_mid on a queue of one million strings, checked for constant time
+# with dudect the same way trace-17 checks insert/remove
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-dm.cmd
+option simulation 1
+dm
+option simulation 0
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 1000000
+# The middle node is tracked while inserting, so every call is constant time
+time dm
+time
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+dm
+time
+# Insertions and removals at both ends keep the middle node tracked
+it RAND 1000
+rh
+rt
+ih RAND 1000
+time
+dm
+time
+free
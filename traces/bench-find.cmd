@@ -0,0 +1,44 @@
+# Membership queries through the hash index of a queue
+# Not run by the driver, use: ./qtest -v 2 -f traces/bench-find.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih dolphin 3
+it gerbil
+ih RAND 1000000
+it bear 2
+# The first lookup builds the index, the others take constant time
+time find dolphin
+time find gerbil 1000000
+find bear
+find meerkat
+# Insertions, removals and deletions keep the index up to date
+rt bear
+find bear
+it bear 5
+find bear 6
+rh
+rh
+dedup all
+find bear
+find dolphin
+free
+# A merge leaves the indexes of the merged queues stale, so the first lookup
+# after it rebuilds the index in linear time, and the others are constant
+new
+ih RAND 100000
+it bear 2
+sort
+find bear
+new
+ih RAND 100000
+it bear 3
+sort
+find bear
+merge
+time find bear
+time find bear 1000000
+rt
+find bear
+free
@@ -0,0 +1,9 @@
+# Throughput of the test harness allocator with growing numbers of threads,
+# each freeing the blocks of another thread before running its own
+# malloc/free pairs
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-harness.cmd
+option malloc 0
+harness 1
+harness 2
+harness 4
+harness 8
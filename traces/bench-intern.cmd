@@ -0,0 +1,11 @@
+# One million copies each of a short and of a 216-byte string in an interning
+# queue. Not run by the driver, use: ./qtest -v 1 -f traces/bench-intern.cmd
+# Set intern to 0 below for the baseline, and compare the peak RSS of both.
+option intern 1
+option fail 0
+option malloc 0
+option timelimit 60
+new
+time ih dolphin 1000000
+time it lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet-lorem-ipsum-dolor-sit-amet- 1000000
+time free
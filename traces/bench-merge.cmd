@@ -0,0 +1,3009 @@
+# Benchmark of q_merge on 1000 sorted queues of 1000 random strings each
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-merge.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+new
+ih RAND 1000
+sort
+time
+merge
+time
+free
@@ -0,0 +1,8 @@
+# Throughput and latency of the lock-free MPMC queue with growing numbers of
+# producer and consumer threads
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-mpmc.cmd
+mpmc 1 1
+mpmc 2 2
+mpmc 4 4
+mpmc 8 1
+mpmc 1 8
@@ -0,0 +1,15 @@
+# Benchmark of q_reverseK on queues of one million strings
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-reverseK.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 1000000
+time reverseK 2
+time reverseK 8
+time reverseK 500000
+# A trailing group shorter than k stays as it is
+it RAND 3
+time reverseK 500000
+time
+free
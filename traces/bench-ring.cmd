@@ -0,0 +1,10 @@
+# Benchmark of FIFO and LIFO workloads on the linked list queue against a
+# ring buffer, after checking the array versions of reverse, swap, reverseK
+# and delete mid against the list ones
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-ring.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+ring 1000000
+option pool 1
+ring 1000000
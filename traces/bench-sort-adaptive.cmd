@@ -0,0 +1,25 @@
+# Benchmark of q_sort on partially ordered queues of two million strings
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-sort-adaptive.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 2000000
+time sort
+# Already sorted
+time sort
+# Reverse sorted
+reverse
+time sort
+# Sorted blocks appended to each other
+it RAND 1000
+time sort
+free
+new
+# Few distinct values, as in trace-14-perf
+ih dolphin 1000000
+it gerbil 1000000
+reverse
+time sort
+time sort
+free
@@ -0,0 +1,32 @@
+# Benchmark of the merge sort against the radix sort engine of q_sort
+# on the inputs of trace-14-perf and trace-15-perf, scaled up to millions
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-sort-radix.cmd
+option fail 0
+option malloc 0
+option timelimit 60
+option sortalgo 0
+new
+ih dolphin 1000000
+it gerbil 1000000
+reverse
+time sort
+free
+new
+ih RAND 1000000
+time sort
+reverse
+time sort
+free
+option sortalgo 1
+new
+ih dolphin 1000000
+it gerbil 1000000
+reverse
+time sort
+free
+new
+ih RAND 1000000
+time sort
+reverse
+time sort
+free
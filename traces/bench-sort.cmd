@@ -0,0 +1,33 @@
+# Benchmark of q_sort on queues of one and ten million random strings,
+# single-threaded and with one thread per CPU
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-sort.cmd
+# For cache behavior, run it under: perf stat -e cache-misses,cache-references
+option fail 0
+option malloc 0
+option timelimit 60
+new
+ih RAND 1000000
+time sort
+reverse
+time sort
+free
+new
+ih RAND 10000000
+time sort
+reverse
+time sort
+free
+# Same inputs sorted with one thread per CPU
+option sortthreads 0
+new
+ih RAND 1000000
+time sort
+reverse
+time sort
+free
+new
+ih RAND 10000000
+time sort
+reverse
+time sort
+free
@@ -0,0 +1,5 @@
+# Throughput and insert-to-remove latency, in CPU cycles, of the wait-free
+# SPSC ring between two threads, then of the MPMC queue with the same threads
+# Not run by the driver, use: ./qtest -v 1 -f traces/bench-spsc.cmd
+spsc
+mpmc 1 1
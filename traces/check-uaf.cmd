@@ -0,0 +1,17 @@
+# A write to a freed block is reported once the quarantine is checked, at the
+# latest by free or quit, even if no later free pushes the block out
+# Not run by the driver, use: ./qtest -v 1 -f traces/check-uaf.cmd
+option fail 0
+option malloc 0
+uaf
+option poison 4
+option quarantine 64
+new
+ih RAND 100
+uaf
+free
+# The block is kept in quarantine however small the quarantine is
+option quarantine 16
+uaf
+option quarantine 0
+uaf
@@ -1,6 +1,7 @@
 # Test performance of insert_tail, reverse, and sort
 option fail 0
 option malloc 0
+option poison 0
 new
 ih dolphin 1000000
 it gerbil 1000000